@@ -0,0 +1,291 @@
+// Microbenchmarks of the hot primitives of the implementations, measured on their own instead of through
+// full ch.bin runs. Every kernel runs on every combination of input size and distribution, each repetition
+// on a fresh copy of the input, and is reported in ns per point and bytes of points per cycle.
+//
+//	./microbench.bin [-n=1000,100000,1000000] [-dist=circle,square,disk,mergekiller] [-r=10] [-k=kernel_filter] [-seed=1]
+
+#include "microbench.hpp"
+#include "thread_phases.hpp"
+#include "implementations/quickhull_common.hpp"
+#include "implementations/dc_preparata_hong.hpp"
+#include "implementations/chan_variants/common.hpp"
+#include "generators/distributions.hpp"
+#include "generators/split_list.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+volatile size_t benchSink = 0;
+
+static BenchInput generateInput(std::string_view distribution, size_t numPoints, uint32_t seed) {
+	std::mt19937 rng(seed);
+	BenchInput input;
+	input.points.resize(numPoints);
+	findNamedDistribution<pointd>(distribution)->generate(input.points, rng);
+	
+	input.leftmost = *std::min_element(input.points.begin(), input.points.end());
+	input.rightmost = *std::max_element(input.points.begin(), input.points.end());
+	for (const pointd& p : input.points) {
+		if (p.sideOfLine(input.leftmost, input.rightmost) == side::left)
+			input.upper.push_back(p);
+	}
+	return input;
+}
+
+struct FurthestPointKernel : Kernel {
+	const BenchInput* input = nullptr;
+	
+	FurthestPointKernel() : Kernel("find_furthest") { }
+	
+	size_t prepare(const BenchInput& _input) override {
+		input = &_input;
+		return input->upper.size();
+	}
+	
+	void run() override {
+		sinkResult(findFurthestPointFromLine<double>(input->upper, input->leftmost, input->rightmost));
+	}
+};
+
+// One partition step of quickhull on the points above the first line, around the furthest point
+template <qhPartitionStrategy S>
+struct PartitionKernel : Kernel {
+	std::vector<pointd> points;
+	pointd leftHullPoint;
+	pointd rightHullPoint;
+	size_t maxPointIdx = 0;
+	
+	explicit PartitionKernel(std::string_view _name) : Kernel(_name) { }
+	
+	size_t prepare(const BenchInput& input) override {
+		points = input.upper;
+		leftHullPoint = input.leftmost;
+		rightHullPoint = input.rightmost;
+		if (!points.empty())
+			maxPointIdx = findFurthestPointFromLine<double>(points, leftHullPoint, rightHullPoint);
+		return points.size();
+	}
+	
+	void run() override {
+		auto [rightPoints, leftPoints] = quickhullPartitionPoints<S, double>(points, leftHullPoint, rightHullPoint, maxPointIdx);
+		sinkResult(rightPoints.size() + leftPoints.size());
+	}
+};
+
+// Both tangents between the hulls of the left and right half of the points, as dc_preparata_hong merges them
+struct TangentKernel : Kernel {
+	std::vector<pointd> points;
+	std::span<pointd> hullA;
+	std::span<pointd> hullB;
+	size_t lowestA = 0, lowestB = 0, highestA = 0, highestB = 0;
+	
+	TangentKernel() : Kernel("find_tangent") { }
+	
+	size_t prepare(const BenchInput& input) override {
+		points = input.points;
+		std::sort(points.begin(), points.end());
+		hullA = std::span<pointd>(points).subspan(0, points.size() / 2);
+		hullB = std::span<pointd>(points).subspan(points.size() / 2);
+		hullA = hullA.subspan(0, monotone_chain(hullA));
+		hullB = hullB.subspan(0, monotone_chain(hullB));
+		
+		auto lowestAndHighest = [] (std::span<pointd> hull, size_t& lowest, size_t& highest) {
+			lowest = highest = 0;
+			for (size_t i = 0; i < hull.size(); i++) {
+				if (hull[i].y < hull[lowest].y)
+					lowest = i;
+				if (hull[i].y > hull[highest].y)
+					highest = i;
+			}
+		};
+		lowestAndHighest(hullA, lowestA, highestA);
+		lowestAndHighest(hullB, lowestB, highestB);
+		return hullA.size() + hullB.size();
+	}
+	
+	void run() override {
+		auto lowerTangent = find_tangent<double>(hullA, hullB, lowestA, lowestB, true);
+		auto upperTangent = find_tangent<double>(hullA, hullB, highestA, highestB, false);
+		sinkResult(lowerTangent.first + lowerTangent.second + upperTangent.first + upperTangent.second);
+	}
+};
+
+// Merge of the hulls of numHulls slices of the points, as the chan variants do it
+struct MergeHullsKernel : Kernel {
+	static constexpr size_t numHulls = 16;
+	
+	std::vector<pointd> points;
+	std::vector<std::span<pointd>> hulls;
+	std::vector<pointd> result;
+	
+	MergeHullsKernel() : Kernel("merge_2d_hulls") { }
+	
+	size_t prepare(const BenchInput& input) override {
+		points = input.points;
+		hulls.clear();
+		size_t numHullPoints = 0;
+		for (size_t i = 0; i < numHulls; i++) {
+			size_t first = points.size() * i / numHulls;
+			size_t last = points.size() * (i + 1) / numHulls;
+			std::span<pointd> slice(points.data() + first, last - first);
+			if (slice.empty())
+				continue;
+			hulls.push_back(slice.subspan(0, monotone_chain(slice)));
+			numHullPoints += hulls.back().size();
+		}
+		result.assign(numHullPoints, pointd());
+		return numHullPoints;
+	}
+	
+	void run() override {
+		sinkResult(Merge2DHulls<double>(hulls, result, 0));
+	}
+};
+
+struct MonotoneChainKernel : Kernel {
+	std::vector<pointd> points;
+	
+	MonotoneChainKernel() : Kernel("monotone_chain") { }
+	
+	size_t prepare(const BenchInput& input) override {
+		points = input.points;
+		return points.size();
+	}
+	
+	void run() override {
+		std::span<pointd> span(points);
+		sinkResult(monotone_chain(span));
+	}
+};
+
+static std::vector<std::unique_ptr<Kernel>> createKernels() {
+	std::vector<std::unique_ptr<Kernel>> kernels;
+	kernels.push_back(std::make_unique<FurthestPointKernel>());
+	kernels.push_back(std::make_unique<PartitionKernel<qhPartitionStrategy::noPartitionByX>>("partition_nxp"));
+	kernels.push_back(std::make_unique<PartitionKernel<qhPartitionStrategy::firstPartitionByX>>("partition_xp"));
+	kernels.push_back(std::make_unique<PartitionKernel<qhPartitionStrategy::singleScan>>("partition_ss"));
+	kernels.push_back(std::make_unique<TangentKernel>());
+	kernels.push_back(std::make_unique<MergeHullsKernel>());
+	kernels.push_back(std::make_unique<MonotoneChainKernel>());
+#ifndef NO_AVX
+	addAvx2Kernels(kernels);
+#endif
+	return kernels;
+}
+
+struct KernelStats {
+	double meanNsPerPoint = 0;
+	double stddevNsPerPoint = 0;
+	double minNsPerPoint = 0;
+	double bytesPerCycle = 0;
+};
+
+// Times repetitions runs of kernel after one untimed warmup run, returns nothing when it has no points to work on
+static std::optional<KernelStats> measure(Kernel& kernel, const BenchInput& input, size_t repetitions) {
+	if (kernel.prepare(input) == 0)
+		return {};
+	kernel.run();
+	
+	std::vector<double> nsPerPoint;
+	uint64_t totalTicks = 0;
+	size_t totalPoints = 0;
+	for (size_t r = 0; r < repetitions; r++) {
+		size_t numPoints = kernel.prepare(input);
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		uint64_t startTicks = readPhaseClock();
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		kernel.run();
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		uint64_t ticks = readPhaseClock() - startTicks;
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		
+		nsPerPoint.push_back(phaseTicksToMs(ticks) * 1e6 / static_cast<double>(numPoints));
+		totalTicks += ticks;
+		totalPoints += numPoints;
+	}
+	
+	KernelStats stats;
+	for (double value : nsPerPoint) {
+		stats.meanNsPerPoint += value / static_cast<double>(nsPerPoint.size());
+	}
+	for (double value : nsPerPoint) {
+		stats.stddevNsPerPoint += (value - stats.meanNsPerPoint) * (value - stats.meanNsPerPoint);
+	}
+	stats.stddevNsPerPoint = nsPerPoint.size() > 1 ? std::sqrt(stats.stddevNsPerPoint / static_cast<double>(nsPerPoint.size() - 1)) : 0;
+	stats.minNsPerPoint = *std::min_element(nsPerPoint.begin(), nsPerPoint.end());
+	stats.bytesPerCycle = static_cast<double>(totalPoints * sizeof(pointd)) / static_cast<double>(std::max<uint64_t>(totalTicks, 1));
+	return stats;
+}
+
+int main(int argc, char** argv) {
+	std::vector<size_t> sizes = { 1000, 100000, 1000000 };
+	std::vector<std::string_view> distributions;
+	for (const NamedDistribution<pointd>& distribution : namedDistributions<pointd>) {
+		distributions.push_back(distribution.name);
+	}
+	size_t repetitions = 10;
+	std::string_view kernelFilter;
+	uint32_t seed = 1;
+	
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		if (arg.starts_with("-n=")) {
+			sizes.clear();
+			for (std::string_view item : splitList(arg.substr(3))) {
+				size_t size = 0;
+				std::from_chars(item.data(), item.data() + item.size(), size);
+				// The merge killer writes the first three points whatever the size
+				sizes.push_back(std::max<size_t>(size, 3));
+			}
+		} else if (arg.starts_with("-dist=")) {
+			distributions = splitList(arg.substr(6));
+		} else if (arg.starts_with("-r=")) {
+			std::from_chars(arg.data() + 3, arg.data() + arg.size(), repetitions);
+			repetitions = std::max<size_t>(repetitions, 1);
+		} else if (arg.starts_with("-k=")) {
+			kernelFilter = arg.substr(3);
+		} else if (arg.starts_with("-seed=")) {
+			std::from_chars(arg.data() + 6, arg.data() + arg.size(), seed);
+		} else {
+			std::cerr << "unknown argument " << arg << "\n";
+			return 1;
+		}
+	}
+	
+	for (std::string_view distribution : distributions) {
+		if (findNamedDistribution<pointd>(distribution) == nullptr) {
+			std::cerr << "unknown distribution " << distribution << ", expected one of " << namedDistributionList<pointd>() << "\n";
+			return 1;
+		}
+	}
+	
+	std::vector<std::unique_ptr<Kernel>> kernels = createKernels();
+	
+	// Cycles are those of the time stamp counter, which runs at the nominal frequency of the CPU
+	std::cout << std::left << std::setw(24) << "kernel" << std::setw(12) << "dist" << std::right << std::setw(10) << "points"
+	          << std::setw(12) << "ns/point" << std::setw(10) << "stddev" << std::setw(10) << "min" << std::setw(10) << "B/cycle" << "\n";
+	std::cout << std::fixed;
+	for (std::string_view distribution : distributions) {
+		for (size_t size : sizes) {
+			BenchInput input = generateInput(distribution, size, seed);
+			for (const std::unique_ptr<Kernel>& kernel : kernels) {
+				if (kernel->name.find(kernelFilter) == std::string_view::npos)
+					continue;
+				std::optional<KernelStats> stats = measure(*kernel, input, repetitions);
+				if (!stats)
+					continue;
+				std::cout << std::left << std::setw(24) << kernel->name << std::setw(12) << distribution << std::right << std::setw(10) << size
+				          << std::setprecision(3) << std::setw(12) << stats->meanNsPerPoint << std::setw(10) << stats->stddevNsPerPoint
+				          << std::setw(10) << stats->minNsPerPoint << std::setw(10) << stats->bytesPerCycle << std::endl;
+			}
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "point.hpp"
+
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// One generated point set, with what the kernels need to start where the implementations do
+struct BenchInput {
+	std::vector<pointd> points;
+	pointd leftmost;
+	pointd rightmost;
+	// The points strictly left of the line from leftmost to rightmost, the input of one quickhull recursion
+	std::vector<pointd> upper;
+};
+
+// A primitive measured on its own. prepare sets up one repetition on a fresh copy of the input outside
+// the timed region and returns the number of points the timed run works on, run is what gets timed.
+struct Kernel {
+	std::string_view name;
+	
+	explicit Kernel(std::string_view _name) : name(_name) { }
+	virtual ~Kernel() { }
+	
+	virtual size_t prepare(const BenchInput& input) = 0;
+	virtual void run() = 0;
+};
+
+// Results of the runs are added to it so that they are not optimized away
+extern volatile size_t benchSink;
+
+inline void sinkResult(size_t value) {
+	benchSink = benchSink + value;
+}
+
+#ifndef NO_AVX
+// The kernels of quickhull_avx2.cpp, added when the CPU has AVX2 and FMA
+void addAvx2Kernels(std::vector<std::unique_ptr<Kernel>>& kernels);
+#endif
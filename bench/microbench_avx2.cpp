@@ -0,0 +1,80 @@
+#include "microbench.hpp"
+#include "implementations/quickhull_avx2.hpp"
+
+#include <cstdlib>
+
+// The points in the vector layout of quickhull_avx2.cpp, rebuilt before every repetition since partitioning reorders them
+struct VectorPoints {
+	char* buffer = nullptr;
+	points pts {};
+	
+	VectorPoints() = default;
+	VectorPoints(const VectorPoints&) = delete;
+	VectorPoints& operator=(const VectorPoints&) = delete;
+	~VectorPoints() {
+		std::free(buffer);
+	}
+	
+	void assign(std::span<const pointd> input) {
+		std::free(buffer);
+		size_t bufferSize = ((input.size() * 2 * sizeof(double)) + 128) & ~31;
+		buffer = static_cast<char*>(std::aligned_alloc(32, bufferSize * 2));
+		__m256d* ptsx = reinterpret_cast<__m256d*>(buffer);
+		__m256d* ptsy = reinterpret_cast<__m256d*>(buffer + bufferSize);
+		initPoints256(input, ptsx, ptsy, NAN);
+		uint32_t vCount = static_cast<uint32_t>((input.size() + 3) / 4);
+		pts = points {
+			.x = ptsx,
+			.y = ptsy,
+			.vcount = vCount,
+			.skipFirst = 0,
+			.skipLast = static_cast<uint8_t>(vCount * 4 - input.size())
+		};
+	}
+};
+
+// The first partition of quickhull_avx2.cpp, all points by the line between the leftmost and rightmost point
+struct PartitionByLineKernel : Kernel {
+	VectorPoints vectorPoints;
+	pointd lineStart;
+	pointd lineEnd;
+	
+	PartitionByLineKernel() : Kernel("avx2_partition_by_line") { }
+	
+	size_t prepare(const BenchInput& input) override {
+		vectorPoints.assign(input.points);
+		lineStart = input.leftmost;
+		lineEnd = input.rightmost;
+		return input.points.size();
+	}
+	
+	void run() override {
+		sinkResult(partitionByLine<true>(vectorPoints.pts, lineStart, lineEnd));
+	}
+};
+
+struct FindMaxPointIndexKernel : Kernel {
+	VectorPoints vectorPoints;
+	pointd offsetPoint;
+	pointd normal;
+	
+	FindMaxPointIndexKernel() : Kernel("avx2_find_max_point") { }
+	
+	size_t prepare(const BenchInput& input) override {
+		vectorPoints.assign(input.upper);
+		offsetPoint = input.leftmost;
+		normal = (input.rightmost - input.leftmost).rotated90CCW();
+		return input.upper.size();
+	}
+	
+	void run() override {
+		sinkResult(static_cast<size_t>(findMaxPointIndex(vectorPoints.pts, offsetPoint, normal)));
+	}
+};
+
+void addAvx2Kernels(std::vector<std::unique_ptr<Kernel>>& kernels) {
+	if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma"))
+		return;
+	kernels.push_back(std::make_unique<PartitionByLineKernel>());
+	kernels.push_back(std::make_unique<FindMaxPointIndexKernel>());
+}
@@ -0,0 +1,237 @@
+// Benchmark suite running the implementations in process over an n-sweep of the generator distributions,
+// instead of regenerating the input with the gen*.bin tools and starting ch.bin once per repetition as
+// run_implementations.py does. Every input is generated once in memory, every run works on a fresh copy.
+//
+//	./suite.bin [impl[:args] ...] [-gen=circle,square,disk,mergekiller] [-n=1000,10000,100000,1000000]
+//	            [-w=1] [-r=5] [-limit=1000] [-seed=1000] [-csv=path]
+//
+// Without implementations every implementation with a double version is run. Once a run of an implementation
+// takes longer than -limit ms on a distribution, the remaining runs and the larger sizes are skipped.
+// The CSV holds the summary and the time of every measured run, space separated, for regression.py.
+
+#include "hull_impl.hpp"
+#include "generators/distributions.hpp"
+#include "generators/split_list.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct SuiteImpl {
+	const HullImpl* impl;
+	std::string_view name; // with the arguments
+	std::string_view args;
+};
+
+struct RunStats {
+	size_t numRuns = 0;
+	double medianMs = 0;
+	double minMs = 0;
+	double stddevMs = 0;
+	size_t numHullPoints = 0;
+	bool overLimit = false;
+	std::vector<double> timesMs; // of the measured runs, in the order they ran
+};
+
+static std::vector<pointd> generateInput(std::string_view generator, size_t numPoints, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::vector<pointd> points(numPoints);
+	findNamedDistribution<pointd>(generator)->generate(points, rng);
+	return points;
+}
+
+// Solves a copy of input, timing only the implementation. Returns the compute time in ms and the hull size.
+static std::pair<double, size_t> runOnce(const SuiteImpl& suiteImpl, const std::vector<pointd>& input,
+                                         std::vector<pointd>& points, SOABuffer<double>& soa) {
+	const HullImpl& impl = *suiteImpl.impl;
+	if (!impl.runDouble) {
+		soa.resize(input.size(), impl.soaAlignment);
+		for (size_t i = 0; i < input.size(); i++) {
+			soa.x[i] = input[i].x;
+			soa.y[i] = input[i].y;
+		}
+	} else {
+		points.assign(input.begin(), input.end());
+	}
+	
+	HullContext context(suiteImpl.args);
+	HullContextScope contextScope(context);
+	auto startTime = std::chrono::steady_clock::now();
+	size_t numHullPoints;
+	if (!impl.runDouble) {
+		numHullPoints = impl.runDoubleSoa(soa.points());
+	} else {
+		impl.runDouble(points);
+		numHullPoints = points.size();
+	}
+	auto endTime = std::chrono::steady_clock::now();
+	return { std::chrono::duration<double, std::milli>(endTime - startTime).count(), numHullPoints };
+}
+
+static RunStats measure(const SuiteImpl& suiteImpl, const std::vector<pointd>& input, size_t numWarmups,
+                        size_t numRuns, double limitMs, std::vector<pointd>& points, SOABuffer<double>& soa) {
+	RunStats stats;
+	for (size_t i = 0; i < numWarmups; i++) {
+		auto [timeMs, numHullPoints] = runOnce(suiteImpl, input, points, soa);
+		stats.numHullPoints = numHullPoints;
+		if (timeMs > limitMs) {
+			stats.overLimit = true;
+			break;
+		}
+	}
+	
+	std::vector<double> timesMs;
+	while (!stats.overLimit && timesMs.size() < numRuns) {
+		auto [timeMs, numHullPoints] = runOnce(suiteImpl, input, points, soa);
+		timesMs.push_back(timeMs);
+		stats.numHullPoints = numHullPoints;
+		stats.overLimit = timeMs > limitMs;
+	}
+	if (timesMs.empty())
+		return stats;
+	
+	stats.timesMs = timesMs;
+	std::sort(timesMs.begin(), timesMs.end());
+	stats.numRuns = timesMs.size();
+	stats.minMs = timesMs.front();
+	size_t mid = timesMs.size() / 2;
+	stats.medianMs = timesMs.size() % 2 ? timesMs[mid] : (timesMs[mid - 1] + timesMs[mid]) / 2;
+	double meanMs = 0;
+	for (double timeMs : timesMs) {
+		meanMs += timeMs / static_cast<double>(timesMs.size());
+	}
+	for (double timeMs : timesMs) {
+		stats.stddevMs += (timeMs - meanMs) * (timeMs - meanMs);
+	}
+	stats.stddevMs = timesMs.size() > 1 ? std::sqrt(stats.stddevMs / static_cast<double>(timesMs.size() - 1)) : 0;
+	return stats;
+}
+
+int main(int argc, char** argv) {
+	std::sort(hullImplementations->begin(), hullImplementations->end(),
+	          [] (const auto& a, const auto& b) { return a.name < b.name; });
+	
+	std::vector<std::string_view> generators;
+	for (const NamedDistribution<pointd>& distribution : namedDistributions<pointd>) {
+		generators.push_back(distribution.name);
+	}
+	std::vector<size_t> sizes = { 1000, 10000, 100000, 1000000 };
+	size_t numWarmups = 1;
+	size_t numRuns = 5;
+	double limitMs = 1000;
+	uint32_t seed = 1000;
+	const char* csvPath = nullptr;
+	std::vector<std::string_view> implNames;
+	
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		if (arg.starts_with("-gen=")) {
+			generators = splitList(arg.substr(5));
+		} else if (arg.starts_with("-n=")) {
+			sizes.clear();
+			for (std::string_view item : splitList(arg.substr(3))) {
+				size_t size = 0;
+				std::from_chars(item.data(), item.data() + item.size(), size);
+				if (size >= 3)
+					sizes.push_back(size);
+			}
+		} else if (arg.starts_with("-w=")) {
+			std::from_chars(arg.data() + 3, arg.data() + arg.size(), numWarmups);
+		} else if (arg.starts_with("-r=")) {
+			std::from_chars(arg.data() + 3, arg.data() + arg.size(), numRuns);
+			numRuns = std::max<size_t>(numRuns, 1);
+		} else if (arg.starts_with("-limit=")) {
+			std::from_chars(arg.data() + 7, arg.data() + arg.size(), limitMs);
+		} else if (arg.starts_with("-seed=")) {
+			std::from_chars(arg.data() + 6, arg.data() + arg.size(), seed);
+		} else if (arg.starts_with("-csv=")) {
+			csvPath = argv[i] + 5;
+		} else if (!arg.starts_with("-")) {
+			implNames.push_back(arg);
+		} else {
+			std::cerr << "unknown argument " << arg << "\n";
+			return 1;
+		}
+	}
+	
+	for (std::string_view generator : generators) {
+		if (findNamedDistribution<pointd>(generator) == nullptr) {
+			std::cerr << "unknown generator " << generator << ", expected one of " << namedDistributionList<pointd>() << "\n";
+			return 1;
+		}
+	}
+	
+	std::vector<SuiteImpl> impls;
+	if (implNames.empty()) {
+		for (const HullImpl& impl : *hullImplementations) {
+			if ((impl.runDouble || impl.runDoubleSoa) && !impl.name.starts_with("bench_"))
+				impls.push_back(SuiteImpl { .impl = &impl, .name = impl.name, .args = {} });
+		}
+	}
+	for (std::string_view fullName : implNames) {
+		size_t colonPos = fullName.find(':');
+		std::string_view name = fullName.substr(0, colonPos);
+		auto it = std::find_if(hullImplementations->begin(), hullImplementations->end(),
+		                       [&] (const HullImpl& impl) { return impl.name == name; });
+		if (it == hullImplementations->end() || (!it->runDouble && !it->runDoubleSoa)) {
+			std::cerr << "no double implementation named " << name << "\n";
+			return 1;
+		}
+		std::string_view args = colonPos == std::string_view::npos ? std::string_view() : fullName.substr(colonPos + 1);
+		impls.push_back(SuiteImpl { .impl = &*it, .name = fullName, .args = args });
+	}
+	
+	std::ofstream csv;
+	if (csvPath != nullptr) {
+		csv.open(csvPath);
+		if (!csv) {
+			std::cerr << "failed to open " << csvPath << "\n";
+			return 1;
+		}
+		csv << "implementation,generator,seed,n,runs,median_ms,min_ms,stddev_ms,hull_points,times_ms\n";
+	}
+	
+	std::cout << std::left << std::setw(24) << "implementation" << std::setw(12) << "generator" << std::right
+	          << std::setw(10) << "n" << std::setw(6) << "runs" << std::setw(12) << "median ms" << std::setw(12) << "min ms"
+	          << std::setw(12) << "stddev ms" << std::setw(10) << "on hull" << "\n";
+	std::cout << std::fixed << std::setprecision(3);
+	
+	std::vector<pointd> points;
+	SOABuffer<double> soa;
+	for (std::string_view generator : generators) {
+		std::vector<bool> overLimit(impls.size(), false);
+		for (size_t size : sizes) {
+			std::vector<pointd> input = generateInput(generator, size, seed);
+			for (size_t i = 0; i < impls.size(); i++) {
+				if (overLimit[i])
+					continue;
+				RunStats stats = measure(impls[i], input, numWarmups, numRuns, limitMs, points, soa);
+				overLimit[i] = stats.overLimit;
+				if (stats.numRuns == 0) {
+					std::cout << std::left << std::setw(24) << impls[i].name << std::setw(12) << generator << std::right
+					          << std::setw(10) << size << "  over the limit of " << limitMs << " ms, skipping larger sizes" << std::endl;
+					continue;
+				}
+				std::cout << std::left << std::setw(24) << impls[i].name << std::setw(12) << generator << std::right
+				          << std::setw(10) << size << std::setw(6) << stats.numRuns << std::setw(12) << stats.medianMs
+				          << std::setw(12) << stats.minMs << std::setw(12) << stats.stddevMs << std::setw(10) << stats.numHullPoints << std::endl;
+				if (csvPath != nullptr) {
+					csv << impls[i].name << "," << generator << "," << seed << "," << size << "," << stats.numRuns << ","
+					    << stats.medianMs << "," << stats.minMs << "," << stats.stddevMs << "," << stats.numHullPoints << ",";
+					for (size_t j = 0; j < stats.timesMs.size(); j++) {
+						csv << (j == 0 ? "" : " ") << stats.timesMs[j];
+					}
+					csv << "\n";
+				}
+			}
+		}
+	}
+}
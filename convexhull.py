@@ -0,0 +1,133 @@
+#Python bindings for libconvexhull (see include/convexhull.h), calling the implementations in process.
+#
+#	import convexhull, numpy as np
+#	points = np.random.rand(1000000, 2)
+#	hull, timings = convexhull.solve("qh_soa", points)
+#
+#Arrays are handed to the library without copying and are overwritten: the hull ends up in their first
+#rows/elements and the returned arrays are views of those. Pass a copy to keep the input.
+#The library is looked up in $CONVEXHULL_LIB, the build directories created by build.sh and _gate_build.
+
+import ctypes
+import os
+import weakref
+from dataclasses import dataclass, field
+
+import numpy as np
+
+CH_INT64 = 0
+CH_DOUBLE = 1
+CH_LAYOUT_AOS = 1
+CH_LAYOUT_SOA = 2
+CH_MAX_PHASES = 16
+CH_MAX_PHASE_NAME = 32
+
+class _Timings(ctypes.Structure):
+	_fields_ = [
+		("compute_ms", ctypes.c_double),
+		("convert_ms", ctypes.c_double),
+		("num_phases", ctypes.c_size_t),
+		("phase_names", (ctypes.c_char * CH_MAX_PHASE_NAME) * CH_MAX_PHASES),
+		("phase_ms", ctypes.c_double * CH_MAX_PHASES),
+	]
+
+@dataclass
+class Timings:
+	computeMs: float = 0.0 #time spent inside the implementation
+	convertMs: float = 0.0 #copying between layouts inside the library, 0 when the arrays were used directly
+	phases: dict = field(default_factory=dict) #intermediate times recorded by the implementation, ms since compute started
+
+def _findLibrary():
+	root = os.path.dirname(os.path.abspath(__file__))
+	candidates = [os.environ.get("CONVEXHULL_LIB", "")]
+	for buildDir in [".build/Release", ".build/RelWithDebInfo", ".build/Debug", "_gate_build"]:
+		candidates.append(os.path.join(root, buildDir, "libconvexhull.so"))
+	for path in candidates:
+		if path and os.path.exists(path):
+			return path
+	raise OSError("libconvexhull.so not found, run ./build.sh or set CONVEXHULL_LIB")
+
+_lib = ctypes.CDLL(_findLibrary())
+_size_p = ctypes.POINTER(ctypes.c_size_t)
+_lib.ch_num_implementations.restype = ctypes.c_size_t
+_lib.ch_implementation_name.argtypes = [ctypes.c_size_t]
+_lib.ch_implementation_name.restype = ctypes.c_char_p
+_lib.ch_implementation_layouts.argtypes = [ctypes.c_char_p, ctypes.c_int]
+_lib.ch_soa_alignment.argtypes = [ctypes.c_char_p]
+_lib.ch_soa_alignment.restype = ctypes.c_size_t
+_lib.ch_soa_capacity.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
+_lib.ch_soa_capacity.restype = ctypes.c_size_t
+_lib.ch_solve_timed.argtypes = [ctypes.c_char_p, ctypes.c_int, ctypes.c_void_p, ctypes.c_size_t, _size_p, ctypes.POINTER(_Timings)]
+_lib.ch_solve_soa_timed.argtypes = [ctypes.c_char_p, ctypes.c_int, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t, ctypes.c_size_t, _size_p, ctypes.POINTER(_Timings)]
+_lib.ch_status_string.argtypes = [ctypes.c_int]
+_lib.ch_status_string.restype = ctypes.c_char_p
+
+def implementations():
+	return [_lib.ch_implementation_name(i).decode() for i in range(_lib.ch_num_implementations())]
+
+def layouts(name, dtype=np.float64):
+	"""Combination of CH_LAYOUT_AOS and CH_LAYOUT_SOA the implementation works on natively, 0 if it has no version for dtype"""
+	return _lib.ch_implementation_layouts(name.encode(), _coordType(dtype))
+
+def _coordType(dtype):
+	dtype = np.dtype(dtype)
+	if dtype == np.float64:
+		return CH_DOUBLE
+	if dtype == np.int64:
+		return CH_INT64
+	raise TypeError(f"unsupported dtype {dtype}, expected float64 or int64")
+
+def _check(status):
+	if status != 0:
+		raise RuntimeError(_lib.ch_status_string(status).decode())
+
+def _toTimings(t):
+	return Timings(t.compute_ms, t.convert_ms, {t.phase_names[i].value.decode(): t.phase_ms[i] for i in range(t.num_phases)})
+
+def solve(name, points):
+	"""Computes the hull of a C contiguous (n, 2) float64 or int64 array in place.
+	Returns a view of its first rows holding the hull, and the Timings of the call."""
+	if points.ndim != 2 or points.shape[1] != 2 or not points.flags.c_contiguous or not points.flags.writeable:
+		raise ValueError("points must be a writeable C contiguous (n, 2) array")
+	numHullPoints = ctypes.c_size_t()
+	timings = _Timings()
+	_check(_lib.ch_solve_timed(name.encode(), _coordType(points.dtype), points.ctypes.data, points.shape[0],
+	                           ctypes.byref(numHullPoints), ctypes.byref(timings)))
+	return points[:numHullPoints.value], _toTimings(timings)
+
+def soa_arrays(name, n, dtype=np.float64):
+	"""Allocates x and y arrays of n elements aligned and padded the way implementation name wants them,
+	so that solve_soa hands them to it without copying."""
+	alignment = _lib.ch_soa_alignment(name.encode())
+	capacity = _lib.ch_soa_capacity(name.encode(), n)
+	itemsize = np.dtype(dtype).itemsize
+	def aligned():
+		raw = np.empty(capacity * itemsize + alignment, dtype=np.uint8)
+		offset = -raw.ctypes.data % alignment
+		_paddedBuffers[raw.ctypes.data + offset] = raw
+		return raw[offset:offset + capacity * itemsize].view(dtype)[:n]
+	return aligned(), aligned()
+
+#Buffers allocated by soa_arrays by the address their arrays start at
+_paddedBuffers = weakref.WeakValueDictionary()
+
+def _capacity(a):
+	#Elements that may be written at a's data, including the padding of arrays from soa_arrays
+	raw = _paddedBuffers.get(a.ctypes.data)
+	if raw is None or a.base is not raw:
+		return a.shape[0]
+	return (raw.ctypes.data + raw.nbytes - a.ctypes.data) // a.itemsize
+
+def solve_soa(name, x, y):
+	"""Computes the hull of separate contiguous x and y arrays in place, without copying when they come
+	from soa_arrays. Returns views of their first elements holding the hull, and the Timings of the call."""
+	if x.dtype != y.dtype or x.shape != y.shape or x.ndim != 1:
+		raise ValueError("x and y must be one dimensional arrays of the same size and dtype")
+	if not (x.flags.c_contiguous and y.flags.c_contiguous and x.flags.writeable and y.flags.writeable):
+		raise ValueError("x and y must be writeable and contiguous")
+	capacity = min(_capacity(x), _capacity(y))
+	numHullPoints = ctypes.c_size_t()
+	timings = _Timings()
+	_check(_lib.ch_solve_soa_timed(name.encode(), _coordType(x.dtype), x.ctypes.data, y.ctypes.data, x.shape[0], capacity,
+	                               ctypes.byref(numHullPoints), ctypes.byref(timings)))
+	return x[:numHullPoints.value], y[:numHullPoints.value], _toTimings(timings)
@@ -0,0 +1,354 @@
+// Differential fuzzer running every registered implementation, int64 and double, on random, degenerate and
+// adversarial inputs and comparing the hulls with those of mc after rotating each to start at its smallest point.
+//
+//	./fuzz.bin [impl[:args] ...] [-skip=impl,...] [-gen=square,disk,...] [-cases=50] [-maxn=10000] [-seed=1]
+//	           [-fast] [-dump=path] [-v]
+//
+// Without implementations all of them but those in -skip are run, except the bench_ sorting baselines. A case is
+// reproduced by -gen=<generator> -seed=<seed of the case> -cases=1 with the same -maxn. -fast runs 10 small cases
+// per generator, quick enough for the Debug build (fuzzd.bin), which is compiled with AddressSanitizer and
+// UndefinedBehaviorSanitizer. -v prints every case and implementation before running it, so that a crash can be
+// traced back (a crash ends the run, skip the implementation to go on). -dump writes the input of the first
+// disagreement in the text format of ch.bin.
+
+#include "hull_impl.hpp"
+#include "generators/distributions.hpp"
+#include "generators/split_list.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct FuzzImpl {
+	const HullImpl* impl;
+	std::string_view name; // with the arguments
+	std::string_view args;
+	size_t numDisagreements[2] = {}; // int64, double
+};
+
+// Generates n points. The int64 version of the input is the points scaled by intScale and rounded, which turns
+// near degenerate double inputs into exactly collinear or duplicate points.
+struct Generator {
+	std::string_view name;
+	double intScale;
+	std::function<void(std::vector<pointd>& points, std::mt19937& rng)> generate;
+};
+
+// Magnitude of the int64 coordinates of the named distributions
+constexpr double INT_COORDINATE_SCALE = 1e6;
+
+static double uniform(std::mt19937& rng, double min, double max) {
+	return std::uniform_real_distribution<double>(min, max)(rng);
+}
+
+static int64_t uniformInt(std::mt19937& rng, int64_t min, int64_t max) {
+	return std::uniform_int_distribution<int64_t>(min, max)(rng);
+}
+
+// Run after the named distributions of the generators
+static const Generator DEGENERATE_GENERATORS[] = {
+	// Few distinct coordinates, so many duplicates and many collinear points on the edges of the hull
+	{ "grid", 1, [] (std::vector<pointd>& points, std::mt19937& rng) {
+		int64_t size = std::max<int64_t>(2, static_cast<int64_t>(std::sqrt(static_cast<double>(points.size()))) / 2);
+		for (pointd& p : points) {
+			p = pointd(static_cast<double>(uniformInt(rng, 0, size - 1)), static_cast<double>(uniformInt(rng, 0, size - 1)));
+		}
+	} },
+	// Every point on one line, exactly representable in both coordinate types
+	{ "collinear", 1, [] (std::vector<pointd>& points, std::mt19937& rng) {
+		pointd start(static_cast<double>(uniformInt(rng, -1000, 1000)), static_cast<double>(uniformInt(rng, -1000, 1000)));
+		pointd dir(static_cast<double>(uniformInt(rng, -5, 5)), static_cast<double>(uniformInt(rng, -5, 5)));
+		if (dir == pointd(0, 0))
+			dir = pointd(1, 0);
+		for (pointd& p : points) {
+			p = start + dir * static_cast<double>(uniformInt(rng, -1000, 1000));
+		}
+	} },
+	// One to four distinct points repeated
+	{ "duplicates", 1, [] (std::vector<pointd>& points, std::mt19937& rng) {
+		std::vector<pointd> distinct(static_cast<size_t>(uniformInt(rng, 1, 4)));
+		for (pointd& p : distinct) {
+			p = pointd(static_cast<double>(uniformInt(rng, -1000, 1000)), static_cast<double>(uniformInt(rng, -1000, 1000)));
+		}
+		for (pointd& p : points) {
+			p = distinct[static_cast<size_t>(uniformInt(rng, 0, static_cast<int64_t>(distinct.size()) - 1))];
+		}
+	} },
+	// The corners of a square, points within 1e-12 of its edges and points inside
+	{ "epsilon", 1e6, [] (std::vector<pointd>& points, std::mt19937& rng) {
+		static const pointd CORNERS[] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+		for (size_t i = 0; i < points.size(); i++) {
+			if (i < 4) {
+				points[i] = CORNERS[i];
+			} else if (i % 2) {
+				size_t edge = static_cast<size_t>(uniformInt(rng, 0, 3));
+				pointd a = CORNERS[edge];
+				pointd b = CORNERS[(edge + 1) % 4];
+				pointd normal = (b - a).rotated90CCW();
+				points[i] = a + (b - a) * uniform(rng, 0, 1) + normal * (uniform(rng, -1, 1) * 1e-12);
+			} else {
+				points[i] = pointd(uniform(rng, -1, 1), uniform(rng, -1, 1));
+			}
+		}
+		std::shuffle(points.begin(), points.end(), rng);
+	} },
+	// Every point on the hull, exactly convex with integer coordinates
+	{ "parabola", 1, [] (std::vector<pointd>& points, std::mt19937& rng) {
+		int64_t range = static_cast<int64_t>(points.size()) * 4;
+		for (pointd& p : points) {
+			double x = static_cast<double>(uniformInt(rng, -range, range));
+			p = pointd(x, x * x);
+		}
+	} },
+	// Square points sorted along x, or against it, as adversarial input orders
+	{ "sorted", 1e4, [] (std::vector<pointd>& points, std::mt19937& rng) {
+		generateSquare<pointd>(points, rng, -100, 100);
+		if (uniformInt(rng, 0, 1))
+			std::sort(points.begin(), points.end());
+		else
+			std::sort(points.begin(), points.end(), std::greater<>());
+	} },
+	// Three to eight points from a 4x4 grid, fewer are outside what the implementations handle
+	{ "tiny", 1, [] (std::vector<pointd>& points, std::mt19937& rng) {
+		points.resize(static_cast<size_t>(uniformInt(rng, 3, 8)));
+		for (pointd& p : points) {
+			p = pointd(static_cast<double>(uniformInt(rng, 0, 3)), static_cast<double>(uniformInt(rng, 0, 3)));
+		}
+	} },
+};
+
+// Solves a copy of input with the int64 or double version of impl, nullopt if it has none
+template <typename T>
+static std::optional<std::vector<point<T>>> solve(const FuzzImpl& fuzzImpl, const std::vector<point<T>>& input) {
+	const HullImpl& impl = *fuzzImpl.impl;
+	HullSolveFunction<T> run;
+	HullSolveFunctionSOA<T> runSoa;
+	if constexpr (std::is_integral_v<T>) {
+		run = impl.runInt;
+		runSoa = impl.runIntSoa;
+	} else {
+		run = impl.runDouble;
+		runSoa = impl.runDoubleSoa;
+	}
+	
+	HullContext context(fuzzImpl.args);
+	HullContextScope contextScope(context);
+	std::vector<point<T>> points;
+	if (runSoa) {
+		SOABuffer<T> soa;
+		soa.resize(input.size(), impl.soaAlignment);
+		for (size_t i = 0; i < input.size(); i++) {
+			soa.x[i] = input[i].x;
+			soa.y[i] = input[i].y;
+		}
+		size_t numHullPoints = runSoa(soa.points());
+		for (size_t i = 0; i < numHullPoints; i++) {
+			points.emplace_back(soa.x[i], soa.y[i]);
+		}
+	} else if (run) {
+		points = input;
+		run(points);
+	} else {
+		return std::nullopt;
+	}
+	
+	// Canonical rotation, starting at the smallest point
+	std::rotate(points.begin(), std::min_element(points.begin(), points.end()), points.end());
+	return points;
+}
+
+template <typename T>
+static void writeInput(const char* path, const std::vector<point<T>>& input) {
+	std::ofstream file(path);
+	file << std::setprecision(17) << "2\n" << input.size() << "\n";
+	for (const point<T>& p : input) {
+		file << p.x << " " << p.y << "\n";
+	}
+	std::cerr << "wrote the input to " << path << (std::is_integral_v<T> ? ", run ch.bin with -i" : "") << "\n";
+}
+
+struct FuzzOptions {
+	bool verbose = false;
+	const char* dumpPath = nullptr;
+};
+
+// Runs every implementation on input and compares with mc, returns the number of disagreements
+template <typename T>
+static size_t fuzzCase(std::vector<FuzzImpl>& impls, const FuzzImpl& reference, const std::vector<point<T>>& input,
+                       const std::string& caseName, FuzzOptions& options) {
+	constexpr size_t TYPE_INDEX = std::is_integral_v<T> ? 0 : 1;
+	constexpr const char* TYPE_NAME = std::is_integral_v<T> ? "int64" : "double";
+	std::vector<point<T>> expected = *solve<T>(reference, input);
+	
+	size_t numDisagreements = 0;
+	for (FuzzImpl& impl : impls) {
+		if (options.verbose)
+			std::cerr << caseName << " " << TYPE_NAME << " " << impl.name << std::endl;
+		std::optional<std::vector<point<T>>> hull;
+		std::string error;
+		try {
+			hull = solve<T>(impl, input);
+			if (!hull)
+				continue;
+		} catch (const std::exception& e) {
+			error = std::string("threw ") + e.what();
+		}
+		if (error.empty() && *hull == expected)
+			continue;
+		
+		if (error.empty()) {
+			size_t firstDifference = 0;
+			while (firstDifference < std::min(hull->size(), expected.size()) && (*hull)[firstDifference] == expected[firstDifference]) {
+				firstDifference++;
+			}
+			error = std::to_string(hull->size()) + " points on hull, mc has " + std::to_string(expected.size())
+			        + ", first difference at " + std::to_string(firstDifference);
+		}
+		std::cout << impl.name << " (" << TYPE_NAME << ") disagrees with mc on " << caseName << ": " << error << std::endl;
+		impl.numDisagreements[TYPE_INDEX]++;
+		numDisagreements++;
+		if (options.dumpPath != nullptr) {
+			writeInput<T>(options.dumpPath, input);
+			options.dumpPath = nullptr;
+		}
+	}
+	return numDisagreements;
+}
+
+int main(int argc, char** argv) {
+	std::sort(hullImplementations->begin(), hullImplementations->end(),
+	          [] (const auto& a, const auto& b) { return a.name < b.name; });
+	
+	std::vector<Generator> allGenerators;
+	for (const NamedDistribution<pointd>& distribution : namedDistributions<pointd>) {
+		allGenerators.push_back(Generator { .name = distribution.name, .intScale = INT_COORDINATE_SCALE / distribution.scale,
+		                                    .generate = [&distribution] (std::vector<pointd>& points, std::mt19937& rng) {
+		                                        distribution.generate(points, rng);
+		                                    } });
+	}
+	allGenerators.insert(allGenerators.end(), std::begin(DEGENERATE_GENERATORS), std::end(DEGENERATE_GENERATORS));
+	std::vector<const Generator*> generators;
+	for (const Generator& generator : allGenerators) {
+		generators.push_back(&generator);
+	}
+	std::optional<size_t> numCases;
+	std::optional<size_t> maxPoints;
+	bool fast = false;
+	uint32_t seed = 1;
+	FuzzOptions options;
+	std::vector<std::string_view> implNames;
+	std::vector<std::string_view> skippedNames;
+	
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		if (arg.starts_with("-gen=")) {
+			generators.clear();
+			for (std::string_view name : splitList(arg.substr(5))) {
+				auto it = std::find_if(allGenerators.begin(), allGenerators.end(), [&] (const Generator& g) { return g.name == name; });
+				if (it == allGenerators.end()) {
+					std::cerr << "unknown generator " << name << ", expected one of";
+					for (const Generator& generator : allGenerators) {
+						std::cerr << " " << generator.name;
+					}
+					std::cerr << "\n";
+					return 1;
+				}
+				generators.push_back(&*it);
+			}
+		} else if (arg.starts_with("-skip=")) {
+			skippedNames = splitList(arg.substr(6));
+		} else if (arg.starts_with("-cases=")) {
+			numCases = 0;
+			std::from_chars(arg.data() + 7, arg.data() + arg.size(), *numCases);
+		} else if (arg.starts_with("-maxn=")) {
+			maxPoints = 0;
+			std::from_chars(arg.data() + 6, arg.data() + arg.size(), *maxPoints);
+		} else if (arg.starts_with("-seed=")) {
+			std::from_chars(arg.data() + 6, arg.data() + arg.size(), seed);
+		} else if (arg.starts_with("-dump=")) {
+			options.dumpPath = argv[i] + 6;
+		} else if (arg == "-fast") {
+			fast = true;
+		} else if (arg == "-v") {
+			options.verbose = true;
+		} else if (!arg.starts_with("-")) {
+			implNames.push_back(arg);
+		} else {
+			std::cerr << "unknown argument " << arg << "\n";
+			return 1;
+		}
+	}
+	size_t casesPerGenerator = numCases.value_or(fast ? 10 : 50);
+	size_t maxNumPoints = std::max<size_t>(maxPoints.value_or(fast ? 200 : 10000), 3);
+	
+	auto mcIt = std::find_if(hullImplementations->begin(), hullImplementations->end(),
+	                         [] (const HullImpl& impl) { return impl.name == "mc"; });
+	if (mcIt == hullImplementations->end()) {
+		std::cerr << "the reference implementation mc is not registered\n";
+		return 1;
+	}
+	FuzzImpl reference { .impl = &*mcIt, .name = "mc", .args = {} };
+	
+	std::vector<FuzzImpl> impls;
+	if (implNames.empty()) {
+		for (const HullImpl& impl : *hullImplementations) {
+			bool skipped = std::find(skippedNames.begin(), skippedNames.end(), impl.name) != skippedNames.end();
+			if (!impl.name.starts_with("bench_") && impl.name != "mc" && !skipped)
+				impls.push_back(FuzzImpl { .impl = &impl, .name = impl.name, .args = {} });
+		}
+	}
+	for (std::string_view fullName : implNames) {
+		size_t colonPos = fullName.find(':');
+		std::string_view name = fullName.substr(0, colonPos);
+		auto it = std::find_if(hullImplementations->begin(), hullImplementations->end(),
+		                       [&] (const HullImpl& impl) { return impl.name == name; });
+		if (it == hullImplementations->end()) {
+			std::cerr << "no implementation named " << name << "\n";
+			return 1;
+		}
+		std::string_view args = colonPos == std::string_view::npos ? std::string_view() : fullName.substr(colonPos + 1);
+		impls.push_back(FuzzImpl { .impl = &*it, .name = fullName, .args = args });
+	}
+	
+	size_t numDisagreements = 0;
+	size_t numRunCases = 0;
+	for (const Generator* generator : generators) {
+		for (size_t caseIndex = 0; caseIndex < casesPerGenerator; caseIndex++) {
+			uint32_t caseSeed = seed + static_cast<uint32_t>(caseIndex);
+			std::mt19937 rng(caseSeed);
+			// Sizes spread evenly over the orders of magnitude up to maxNumPoints
+			double logSize = uniform(rng, std::log(3.0), std::log(static_cast<double>(maxNumPoints) + 1));
+			std::vector<pointd> input(std::min(maxNumPoints, static_cast<size_t>(std::exp(logSize))));
+			generator->generate(input, rng);
+			
+			std::vector<pointi> intInput(input.size());
+			for (size_t i = 0; i < input.size(); i++) {
+				intInput[i] = pointi(std::llround(input[i].x * generator->intScale), std::llround(input[i].y * generator->intScale));
+			}
+			
+			std::string caseName = std::string(generator->name) + " seed=" + std::to_string(caseSeed) + " n=" + std::to_string(input.size());
+			numDisagreements += fuzzCase<int64_t>(impls, reference, intInput, caseName, options);
+			numDisagreements += fuzzCase<double>(impls, reference, input, caseName, options);
+			numRunCases++;
+		}
+	}
+	
+	std::cout << numRunCases << " cases of " << generators.size() << " generators, " << numDisagreements << " disagreements\n";
+	for (const FuzzImpl& impl : impls) {
+		if (impl.numDisagreements[0] || impl.numDisagreements[1]) {
+			std::cout << std::left << std::setw(28) << impl.name << std::right << " int64: " << std::setw(4) << impl.numDisagreements[0]
+			          << "  double: " << std::setw(4) << impl.numDisagreements[1] << "\n";
+		}
+	}
+	return numDisagreements ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+#ifndef CONVEXHULL_H
+#define CONVEXHULL_H
+
+/*
+ * C interface of libconvexhull, giving access to every hull implementation of ch.bin
+ * without going through its text or binary I/O.
+ *
+ * Implementations register themselves from static initializers. When linking the static
+ * library, link it as a whole archive (-Wl,--whole-archive -lconvexhull -Wl,--no-whole-archive)
+ * or the implementations are dropped by the linker. The shared library needs nothing special.
+ *
+ * Every call runs in a context of its own, so calls from different threads can run concurrently.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define CONVEXHULL_API
+#else
+#define CONVEXHULL_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum ch_coord_type {
+	CH_INT64 = 0,
+	CH_DOUBLE = 1
+} ch_coord_type;
+
+/* Bits returned by ch_implementation_layouts, telling which layouts an implementation works on natively */
+enum {
+	CH_LAYOUT_AOS = 1,
+	CH_LAYOUT_SOA = 2
+};
+
+typedef enum ch_status {
+	CH_OK = 0,
+	CH_ERROR_UNKNOWN_IMPLEMENTATION = -1,
+	CH_ERROR_UNSUPPORTED_TYPE = -2,
+	CH_ERROR_INVALID_ARGUMENT = -3,
+	CH_ERROR_INTERNAL = -4
+} ch_status;
+
+#define CH_MAX_PHASES 16
+#define CH_MAX_PHASE_NAME 32
+
+typedef struct ch_timings {
+	double compute_ms; /* time spent inside the implementation */
+	double convert_ms; /* copying between the caller's layout and the implementation's, 0 when solved in place */
+	size_t num_phases; /* intermediate times recorded by the implementation, at most CH_MAX_PHASES */
+	char phase_names[CH_MAX_PHASES][CH_MAX_PHASE_NAME];
+	double phase_ms[CH_MAX_PHASES]; /* since compute started */
+} ch_timings;
+
+/* Implementations are listed in alphabetical order. Names stay valid until the library is unloaded. */
+CONVEXHULL_API size_t ch_num_implementations(void);
+CONVEXHULL_API const char* ch_implementation_name(size_t index);
+
+/* Returns a combination of CH_LAYOUT_AOS and CH_LAYOUT_SOA, or 0 if the implementation does not exist
+ * or has no version for the coordinate type. */
+CONVEXHULL_API int ch_implementation_layouts(const char* name, ch_coord_type type);
+
+/* SOA implementations process the x and y arrays in aligned blocks. When both arrays start at a multiple
+ * of ch_soa_alignment bytes and have room for ch_soa_capacity elements, ch_solve_soa works on them
+ * directly and overwrites the elements past num_points. Otherwise the points are copied. */
+CONVEXHULL_API size_t ch_soa_alignment(const char* name);
+CONVEXHULL_API size_t ch_soa_capacity(const char* name, size_t num_points);
+
+/* Computes the hull of num_points points stored as interleaved x, y pairs of the given type.
+ * name may be followed by ":args", as on the ch.bin command line. The hull is written to the
+ * start of points in the order the implementation produces it, its size to *num_hull_points. */
+CONVEXHULL_API ch_status ch_solve(const char* name, ch_coord_type type, void* points, size_t num_points,
+                                  size_t* num_hull_points);
+
+/* Like ch_solve for separate x and y arrays of capacity elements each, capacity >= num_points. */
+CONVEXHULL_API ch_status ch_solve_soa(const char* name, ch_coord_type type, void* x, void* y, size_t num_points,
+                                      size_t capacity, size_t* num_hull_points);
+
+/* Variants that also fill *timings */
+CONVEXHULL_API ch_status ch_solve_timed(const char* name, ch_coord_type type, void* points, size_t num_points,
+                                        size_t* num_hull_points, ch_timings* timings);
+CONVEXHULL_API ch_status ch_solve_soa_timed(const char* name, ch_coord_type type, void* x, void* y, size_t num_points,
+                                            size_t capacity, size_t* num_hull_points, ch_timings* timings);
+
+CONVEXHULL_API const char* ch_status_string(ch_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,216 @@
+#Usage: python3 regression.py record -b=baseline.json [-a="suite args"] [-csv=results.csv]
+#       python3 regression.py compare -b=baseline.json [-a="suite args"] [-csv=results.csv] [-t=10] [-p=0.01]
+#record runs suite.bin (or reads the CSV of an earlier run of it) and stores the time of every run per
+#implementation, generator and n in a baseline, together with a description of the machine. compare runs the
+#suite again, with the arguments stored in the baseline unless -a is given, and tests every entry against the
+#baseline. An entry regressed when its median is more than -t percent slower and a one sided Mann-Whitney U test
+#gives p below -p. Exits with 1 if an entry regressed, changed its hull size, is missing from the new run or has
+#too few runs in the baseline or the new run for the test to reach p below -p at all.
+
+import testlib
+import csv
+import datetime
+import json
+import math
+import os
+import platform
+import shlex
+import subprocess
+import sys
+import tempfile
+
+BASELINE_FORMAT = 1
+DEFAULT_SUITE_ARGS = "-r=10"
+
+def machineDescription():
+	cpu = platform.processor()
+	try:
+		with open("/proc/cpuinfo") as f:
+			for line in f:
+				if line.startswith("model name"):
+					cpu = line.split(":", maxsplit=1)[1].strip()
+					break
+	except OSError:
+		pass
+	try:
+		commit = subprocess.run(["git", "rev-parse", "HEAD"], capture_output=True, text=True).stdout.strip()
+		dirty = subprocess.run(["git", "status", "--porcelain", "--untracked-files=no"], capture_output=True, text=True).stdout.strip() != ""
+	except OSError:
+		commit, dirty = "", False
+	return {
+		"hostname": platform.node(),
+		"cpu": cpu,
+		"cores": os.cpu_count(),
+		"system": platform.platform(),
+		"python": platform.python_version(),
+		"git_commit": commit,
+		"git_dirty": dirty,
+	}
+
+# Differences that make timings incomparable, the commit is expected to differ
+COMPARABLE_MACHINE_KEYS = ["hostname", "cpu", "cores", "system"]
+
+def runSuite(suiteArgs):
+	with tempfile.TemporaryDirectory() as tmp:
+		csvPath = os.path.join(tmp, "results.csv")
+		command = ["./suite.bin"] + shlex.split(suiteArgs) + [f"-csv={csvPath}"]
+		print(" ".join(command))
+		if subprocess.run(command).returncode != 0:
+			print("suite.bin failed")
+			exit(2)
+		return readSuiteCsv(csvPath)
+
+def readSuiteCsv(path):
+	results = []
+	with open(path) as f:
+		for row in csv.DictReader(f):
+			if "times_ms" not in row:
+				print(f"{path} has no times_ms column, it was written by an older suite.bin")
+				exit(2)
+			results.append({
+				"implementation": row["implementation"],
+				"generator": row["generator"],
+				"seed": int(row["seed"]),
+				"n": int(row["n"]),
+				"hull_points": int(row["hull_points"]),
+				"times_ms": [float(t) for t in row["times_ms"].split()],
+			})
+	return results
+
+def entryKey(entry):
+	return (entry["implementation"], entry["generator"], entry["n"])
+
+def median(values):
+	values = sorted(values)
+	mid = len(values) // 2
+	return values[mid] if len(values) % 2 else (values[mid - 1] + values[mid]) / 2
+
+def normalUpperTail(z):
+	return 0.5 * math.erfc(z / math.sqrt(2))
+
+# Number of orderings of n1 + n2 distinct values in which the U statistic of the second sample is u,
+# for every u, by the recurrence over whether the largest value belongs to the first or second sample
+def exactUDistribution(n1, n2):
+	counts = {(0, 0): [1]}
+	for i in range(n1 + 1):
+		for j in range(n2 + 1):
+			if i == 0 and j == 0:
+				continue
+			dist = [0] * (i * j + 1)
+			if i > 0:
+				for u, c in enumerate(counts[(i - 1, j)]):
+					dist[u] += c
+			if j > 0:
+				for u, c in enumerate(counts[(i, j - 1)]):
+					dist[u + i] += c
+			counts[(i, j)] = dist
+	return counts[(n1, n2)]
+
+# One sided Mann-Whitney U test of whether values of b tend to be larger than values of a. Exact without
+# ties for small samples, otherwise the normal approximation with tie and continuity correction.
+def mannWhitneyGreater(a, b):
+	n1, n2 = len(a), len(b)
+	u = sum(1.0 if y > x else 0.5 if y == x else 0.0 for x in a for y in b)
+	hasTies = len(set(a) | set(b)) < n1 + n2
+	if not hasTies and n1 * n2 <= 400:
+		dist = exactUDistribution(n1, n2)
+		return sum(dist[math.ceil(u):]) / sum(dist)
+
+	values = sorted(a + b)
+	tieTerm = 0
+	i = 0
+	while i < len(values):
+		j = i
+		while j < len(values) and values[j] == values[i]:
+			j += 1
+		tieTerm += (j - i) ** 3 - (j - i)
+		i = j
+	n = n1 + n2
+	sigma = math.sqrt(n1 * n2 / 12 * ((n + 1) - tieTerm / (n * (n - 1))))
+	if sigma == 0:
+		return 1.0
+	return normalUpperTail((u - n1 * n2 / 2 - 0.5) / sigma)
+
+# The smallest p value mannWhitneyGreater can give for samples of these sizes, when every value of the second
+# is larger than every value of the first
+def smallestPValue(n1, n2):
+	return mannWhitneyGreater(list(range(n1)), list(range(n1, n1 + n2)))
+
+def record(baselinePath):
+	suiteArgs = testlib.getcmdarg("a", DEFAULT_SUITE_ARGS)
+	csvPath = testlib.getcmdarg("csv", "")
+	results = readSuiteCsv(csvPath) if csvPath else runSuite(suiteArgs)
+	baseline = {
+		"format": BASELINE_FORMAT,
+		"created": datetime.datetime.now().isoformat(timespec="seconds"),
+		"machine": machineDescription(),
+		"suite_args": suiteArgs,
+		"results": results,
+	}
+	with open(baselinePath, "w") as f:
+		json.dump(baseline, f, indent=1)
+	print(f"stored {len(results)} entries in {baselinePath}")
+
+def compare(baselinePath):
+	with open(baselinePath) as f:
+		baseline = json.load(f)
+	if baseline.get("format") != BASELINE_FORMAT:
+		print(f"{baselinePath} is not a baseline of format {BASELINE_FORMAT}")
+		exit(2)
+	threshold = float(testlib.getcmdarg("t", 10)) / 100
+	alpha = float(testlib.getcmdarg("p", 0.01))
+	csvPath = testlib.getcmdarg("csv", "")
+
+	machine = machineDescription()
+	for key in COMPARABLE_MACHINE_KEYS:
+		if baseline["machine"].get(key) != machine[key]:
+			print(f"warning: {key} differs from the baseline: {baseline['machine'].get(key)} now {machine[key]}")
+	print(f"baseline of {baseline['created']} at commit {baseline['machine']['git_commit'][:12] or '?'}, now at {machine['git_commit'][:12] or '?'}")
+
+	results = readSuiteCsv(csvPath) if csvPath else runSuite(testlib.getcmdarg("a", baseline["suite_args"]))
+	current = {entryKey(entry): entry for entry in results}
+
+	print(f"{'implementation':<24}{'generator':<12}{'n':>10}{'base ms':>12}{'new ms':>12}{'change':>9}{'p (MW)':>10}  verdict")
+	failures = 0
+	for old in baseline["results"]:
+		key = entryKey(old)
+		new = current.get(key)
+		line = f"{key[0]:<24}{key[1]:<12}{key[2]:>10}{median(old['times_ms']):>12.3f}"
+		if new is None:
+			print(line + " " * 33 + "missing")
+			failures += 1
+			continue
+
+		oldTimes, newTimes = old["times_ms"], new["times_ms"]
+		change = median(newTimes) / median(oldTimes) - 1
+		if change >= 0:
+			pValue = mannWhitneyGreater(oldTimes, newTimes)
+		else:
+			pValue = mannWhitneyGreater(newTimes, oldTimes)
+
+		verdict = ""
+		if new["hull_points"] != old["hull_points"]:
+			verdict = f"hull size changed from {old['hull_points']} to {new['hull_points']}"
+			failures += 1
+		elif smallestPValue(len(oldTimes), len(newTimes)) >= alpha:
+			# Would pass whatever the times, the runs cannot show a regression
+			verdict = f"inconclusive, {len(oldTimes)} and {len(newTimes)} runs cannot reach p < {alpha:g}"
+			failures += 1
+		elif abs(change) > threshold and pValue < alpha:
+			verdict = "REGRESSION" if change > 0 else "improved"
+			failures += change > 0
+		print(line + f"{median(newTimes):>12.3f}{change * 100:>8.1f}%{pValue:>10.4f}  {verdict}")
+
+	if failures:
+		print(f"{failures} of {len(baseline['results'])} entries regressed, changed, are missing or have too few runs")
+		exit(1)
+	print(f"no regressions in {len(baseline['results'])} entries (threshold {threshold * 100:g}%, p < {alpha:g})")
+
+if __name__ == "__main__":
+	if len(sys.argv) < 2 or sys.argv[1] not in ["record", "compare"]:
+		print("usage: python3 regression.py record|compare -b=baseline.json [-a=\"suite args\"] [-csv=results.csv] [-t=10] [-p=0.01]")
+		exit(2)
+	if sys.argv[1] == "record":
+		record(testlib.getcmdarg("b"))
+	else:
+		compare(testlib.getcmdarg("b"))
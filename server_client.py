@@ -0,0 +1,116 @@
+#Usage: python3 server_client.py -i=implementation -f=input_file [-s=socket_path] [-n=requests] [-c=connections] [-a="-i -q"]
+#Sends the same point set to a running "./ch.bin -server=socket_path" (or to a "./ch.bin -server" it starts
+#itself when -s is not given) and reports throughput and latency percentiles.
+
+import testlib
+import socket
+import subprocess
+import threading
+import time
+
+implName = testlib.getcmdarg("i")
+inputFile = testlib.getcmdarg("f")
+socketPath = testlib.getcmdarg("s", "")
+numRequests = int(testlib.getcmdarg("n", 1000))
+numConnections = int(testlib.getcmdarg("c", 1))
+requestArgs = testlib.getcmdarg("a", "-q")
+
+with open(inputFile, "rb") as f:
+	payload = f.read()
+request = f"{implName} {len(payload)} {requestArgs}\n".encode() + payload
+
+class PipeConnection:
+	def __init__(self):
+		self.proc = subprocess.Popen(["./ch.bin", "-server"], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+	def send(self, data):
+		self.proc.stdin.write(data)
+		self.proc.stdin.flush()
+	def readline(self):
+		return self.proc.stdout.readline()
+	def read(self, size):
+		return self.proc.stdout.read(size)
+	def close(self):
+		self.proc.stdin.close()
+		self.proc.wait()
+
+class SocketConnection:
+	def __init__(self):
+		self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+		self.sock.connect(socketPath)
+		self.file = self.sock.makefile("rb")
+	def send(self, data):
+		self.sock.sendall(data)
+	def readline(self):
+		return self.file.readline()
+	def read(self, size):
+		return self.file.read(size)
+	def close(self):
+		self.file.close()
+		self.sock.close()
+
+def sendRequest(conn):
+	conn.send(request)
+	status, size, *rest = conn.readline().decode().split()
+	body = conn.read(int(size))
+	if status != "ok":
+		raise RuntimeError(body.decode())
+	return float(rest[0]), body
+
+if socketPath == "":
+	numConnections = 1
+
+connections = [SocketConnection() if socketPath != "" else PipeConnection() for _ in range(numConnections)]
+
+#One request per connection first, so that buffers are allocated before measuring
+firstBody = None
+for conn in connections:
+	_, firstBody = sendRequest(conn)
+
+latencies = []
+computeTimes = []
+errors = []
+lock = threading.Lock()
+
+def worker(conn, count):
+	local = []
+	localCompute = []
+	try:
+		for _ in range(count):
+			start = time.perf_counter()
+			computeTime, body = sendRequest(conn)
+			local.append((time.perf_counter() - start) * 1000)
+			localCompute.append(computeTime)
+			if body != firstBody:
+				raise RuntimeError("reply differs from the first reply")
+	except Exception as e:
+		with lock:
+			errors.append(str(e))
+	with lock:
+		latencies.extend(local)
+		computeTimes.extend(localCompute)
+
+threads = []
+start = time.perf_counter()
+for i, conn in enumerate(connections):
+	count = numRequests // numConnections + (1 if i < numRequests % numConnections else 0)
+	threads.append(threading.Thread(target=worker, args=(conn, count)))
+	threads[-1].start()
+for t in threads:
+	t.join()
+totalTime = time.perf_counter() - start
+
+for conn in connections:
+	conn.close()
+
+for e in errors:
+	print("error:", e)
+if len(latencies) == 0:
+	exit(1)
+
+def percentile(values, p):
+	values = sorted(values)
+	return values[min(len(values) - 1, int(p / 100 * len(values)))]
+
+print(f"requests: {len(latencies)} over {numConnections} connections in {totalTime:.3f} s, {len(latencies) / totalTime:.1f} requests/s")
+print("latency:", ", ".join(f"p{p} {percentile(latencies, p):.3f} ms" for p in [50, 90, 99, 99.9]), f"max {max(latencies):.3f} ms")
+print(f"average compute time: {sum(computeTimes) / len(computeTimes):.3f} ms")
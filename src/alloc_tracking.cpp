@@ -0,0 +1,119 @@
+#include "alloc_tracking.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+
+#include <malloc.h>
+
+static std::atomic<bool> tracking { false };
+static std::atomic<uint64_t> numAllocations { 0 };
+static std::atomic<uint64_t> bytesAllocated { 0 };
+static std::atomic<int64_t> currentBytes { 0 };
+static std::atomic<int64_t> peakBytes { 0 };
+
+#if !defined(__SANITIZE_ADDRESS__) && defined(__GLIBC__)
+#define HAS_ALLOCATION_TRACKING
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+static void trackAllocated(void* ptr) {
+	if (ptr == nullptr || !tracking.load(std::memory_order_relaxed))
+		return;
+	int64_t size = static_cast<int64_t>(malloc_usable_size(ptr));
+	numAllocations.fetch_add(1, std::memory_order_relaxed);
+	bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+	int64_t current = currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	int64_t peak = peakBytes.load(std::memory_order_relaxed);
+	while (current > peak && !peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) { }
+}
+
+static void trackFreed(void* ptr) {
+	if (ptr == nullptr || !tracking.load(std::memory_order_relaxed))
+		return;
+	currentBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+}
+
+// Replacements of the glibc allocation functions. Symbols defined in the executable take precedence
+// over libc's for every library loaded into the process.
+extern "C" {
+
+void* malloc(size_t size) {
+	void* ptr = __libc_malloc(size);
+	trackAllocated(ptr);
+	return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+	void* ptr = __libc_calloc(count, size);
+	trackAllocated(ptr);
+	return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+	trackFreed(ptr);
+	void* newPtr = __libc_realloc(ptr, size);
+	// A failed realloc leaves the old block in place
+	trackAllocated(newPtr == nullptr && size != 0 ? ptr : newPtr);
+	return newPtr;
+}
+
+void free(void* ptr) {
+	trackFreed(ptr);
+	__libc_free(ptr);
+}
+
+void* memalign(size_t alignment, size_t size) {
+	void* ptr = __libc_memalign(alignment, size);
+	trackAllocated(ptr);
+	return ptr;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+	return memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) {
+	if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+		return EINVAL;
+	void* ptr = memalign(alignment, size);
+	if (ptr == nullptr && size != 0)
+		return ENOMEM;
+	*result = ptr;
+	return 0;
+}
+
+}
+#endif
+
+bool allocationTrackingAvailable() {
+#ifdef HAS_ALLOCATION_TRACKING
+	return true;
+#else
+	return false;
+#endif
+}
+
+void beginAllocationTracking() {
+	numAllocations = 0;
+	bytesAllocated = 0;
+	currentBytes = 0;
+	peakBytes = 0;
+	tracking = true;
+}
+
+AllocationStats endAllocationTracking() {
+	tracking = false;
+	return AllocationStats {
+		.numAllocations = numAllocations.load(),
+		.bytesAllocated = bytesAllocated.load(),
+		.peakBytes = peakBytes.load(),
+	};
+}
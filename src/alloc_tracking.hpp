@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+struct AllocationStats {
+	uint64_t numAllocations = 0;
+	uint64_t bytesAllocated = 0;
+	// Highest amount of memory held above what was held when tracking began. Memory allocated
+	// earlier and freed while tracking lowers the baseline, so this can be less than bytesAllocated.
+	int64_t peakBytes = 0;
+};
+
+// Counts every heap allocation of the process (malloc and friends, which operator new, the parallel
+// STL and aligned_alloc all end up in) between begin and end, from all threads. The tracking
+// replaces the glibc allocation functions in ch.bin and forwards to them, it is not available in
+// builds with AddressSanitizer.
+bool allocationTrackingAvailable();
+void beginAllocationTracking();
+AllocationStats endAllocationTracking();
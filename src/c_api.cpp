@@ -0,0 +1,261 @@
+#include "convexhull.h"
+#include "hull_impl.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ComputeTimer {
+	std::chrono::high_resolution_clock::time_point startTime;
+	std::chrono::high_resolution_clock::time_point endTime;
+	
+	void begin() { startTime = std::chrono::high_resolution_clock::now(); }
+	void end() { endTime = std::chrono::high_resolution_clock::now(); }
+};
+
+static const std::vector<std::string>& implementationNames() {
+	static const std::vector<std::string> names = [] {
+		std::sort(hullImplementations->begin(), hullImplementations->end(),
+		          [] (const auto& a, const auto& b) { return a.name < b.name; });
+		std::vector<std::string> result;
+		for (const HullImpl& impl : *hullImplementations) {
+			result.emplace_back(impl.name);
+		}
+		return result;
+	}();
+	return names;
+}
+
+// Splits "name:args" and looks up the implementation, returns nullptr if there is none
+static const HullImpl* findImplementation(const char* fullName, std::string_view* args = nullptr) {
+	if (fullName == nullptr)
+		return nullptr;
+	implementationNames();
+	
+	std::string_view name = fullName;
+	size_t colonPos = name.find(':');
+	if (args != nullptr)
+		*args = colonPos == std::string_view::npos ? std::string_view() : name.substr(colonPos + 1);
+	name = name.substr(0, colonPos);
+	
+	auto it = std::find_if(hullImplementations->begin(), hullImplementations->end(),
+	                       [&] (const HullImpl& impl) { return impl.name == name; });
+	return it == hullImplementations->end() ? nullptr : &*it;
+}
+
+template <typename T>
+static HullSolveFunction<T> aosFunction(const HullImpl& impl) {
+	if constexpr (std::is_integral_v<T>) {
+		return impl.runInt;
+	} else {
+		return impl.runDouble;
+	}
+}
+
+template <typename T>
+static HullSolveFunctionSOA<T> soaFunction(const HullImpl& impl) {
+	if constexpr (std::is_integral_v<T>) {
+		return impl.runIntSoa;
+	} else {
+		return impl.runDoubleSoa;
+	}
+}
+
+template <typename T>
+static size_t solveAos(const HullImpl& impl, point<T>* points, size_t numPoints, ComputeTimer& timer) {
+	if (HullSolveFunction<T> run = aosFunction<T>(impl)) {
+		std::vector<point<T>> buffer(points, points + numPoints);
+		timer.begin();
+		run(buffer);
+		timer.end();
+		std::copy(buffer.begin(), buffer.end(), points);
+		return buffer.size();
+	}
+	
+	SOABuffer<T> soa;
+	soa.resize(numPoints, impl.soaAlignment);
+	for (size_t i = 0; i < numPoints; i++) {
+		soa.x[i] = points[i].x;
+		soa.y[i] = points[i].y;
+	}
+	timer.begin();
+	size_t numHullPoints = soaFunction<T>(impl)(soa.points());
+	timer.end();
+	for (size_t i = 0; i < numHullPoints; i++) {
+		points[i] = point<T>(soa.x[i], soa.y[i]);
+	}
+	return numHullPoints;
+}
+
+template <typename T>
+static size_t solveSoa(const HullImpl& impl, T* x, T* y, size_t numPoints, size_t capacity, ComputeTimer& timer) {
+	HullSolveFunctionSOA<T> runSoa = soaFunction<T>(impl);
+	if (!runSoa) {
+		std::vector<point<T>> buffer(numPoints);
+		for (size_t i = 0; i < numPoints; i++) {
+			buffer[i] = point<T>(x[i], y[i]);
+		}
+		timer.begin();
+		aosFunction<T>(impl)(buffer);
+		timer.end();
+		for (size_t i = 0; i < buffer.size(); i++) {
+			x[i] = buffer[i].x;
+			y[i] = buffer[i].y;
+		}
+		return buffer.size();
+	}
+	
+	size_t alignment = SOABuffer<T>::alignmentFor(impl.soaAlignment);
+	size_t paddedSize = SOABuffer<T>::paddedSize(numPoints, impl.soaAlignment);
+	bool isAligned = reinterpret_cast<uintptr_t>(x) % alignment == 0 && reinterpret_cast<uintptr_t>(y) % alignment == 0;
+	if (isAligned && capacity >= paddedSize) {
+		for (size_t i = numPoints; i < paddedSize; i++) {
+			x[i] = point<T>::notOnHull.x;
+			y[i] = point<T>::notOnHull.y;
+		}
+		timer.begin();
+		size_t numHullPoints = runSoa(SOAPoints<T> { .x = { x, numPoints }, .y = { y, numPoints } });
+		timer.end();
+		return numHullPoints;
+	}
+	
+	SOABuffer<T> soa;
+	soa.resize(numPoints, impl.soaAlignment);
+	std::copy_n(x, numPoints, soa.x);
+	std::copy_n(y, numPoints, soa.y);
+	timer.begin();
+	size_t numHullPoints = runSoa(soa.points());
+	timer.end();
+	std::copy_n(soa.x, numHullPoints, x);
+	std::copy_n(soa.y, numHullPoints, y);
+	return numHullPoints;
+}
+
+static double msBetween(std::chrono::high_resolution_clock::time_point a, std::chrono::high_resolution_clock::time_point b) {
+	return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Runs solve in a context of its own, after checking that the implementation exists
+// and has a version for the coordinate type
+template <typename F>
+static ch_status runInContext(const char* fullName, ch_coord_type type, size_t* numHullPoints, ch_timings* timings, F solve) {
+	if (numHullPoints == nullptr || (type != CH_INT64 && type != CH_DOUBLE))
+		return CH_ERROR_INVALID_ARGUMENT;
+	std::string_view args;
+	const HullImpl* impl = findImplementation(fullName, &args);
+	if (impl == nullptr)
+		return CH_ERROR_UNKNOWN_IMPLEMENTATION;
+	if (ch_implementation_layouts(fullName, type) == 0)
+		return CH_ERROR_UNSUPPORTED_TYPE;
+	
+	HullContext context(args);
+	HullContextScope contextScope(context);
+	ch_status status = CH_OK;
+	ComputeTimer timer;
+	auto startTime = std::chrono::high_resolution_clock::now();
+	try {
+		*numHullPoints = solve(*impl, timer);
+	} catch (...) {
+		status = CH_ERROR_INTERNAL;
+	}
+	auto endTime = std::chrono::high_resolution_clock::now();
+	
+	if (timings != nullptr) {
+		*timings = {};
+		timings->compute_ms = msBetween(timer.startTime, timer.endTime);
+		timings->convert_ms = msBetween(startTime, endTime) - timings->compute_ms;
+		for (const auto& [name, time] : context.getIntermediateTimes()) {
+			if (timings->num_phases == CH_MAX_PHASES)
+				break;
+			size_t nameLength = std::min<size_t>(name.size(), CH_MAX_PHASE_NAME - 1);
+			std::memcpy(timings->phase_names[timings->num_phases], name.data(), nameLength);
+			timings->phase_ms[timings->num_phases] = msBetween(timer.startTime, time);
+			timings->num_phases++;
+		}
+	}
+	return status;
+}
+
+extern "C" {
+
+size_t ch_num_implementations(void) {
+	return implementationNames().size();
+}
+
+const char* ch_implementation_name(size_t index) {
+	const std::vector<std::string>& names = implementationNames();
+	return index < names.size() ? names[index].c_str() : nullptr;
+}
+
+int ch_implementation_layouts(const char* name, ch_coord_type type) {
+	const HullImpl* impl = findImplementation(name);
+	if (impl == nullptr)
+		return 0;
+	bool aos = type == CH_INT64 ? static_cast<bool>(impl->runInt) : static_cast<bool>(impl->runDouble);
+	bool soa = type == CH_INT64 ? static_cast<bool>(impl->runIntSoa) : static_cast<bool>(impl->runDoubleSoa);
+	return (aos ? CH_LAYOUT_AOS : 0) | (soa ? CH_LAYOUT_SOA : 0);
+}
+
+size_t ch_soa_alignment(const char* name) {
+	const HullImpl* impl = findImplementation(name);
+	return SOABuffer<double>::alignmentFor(impl == nullptr ? 0 : impl->soaAlignment);
+}
+
+size_t ch_soa_capacity(const char* name, size_t num_points) {
+	const HullImpl* impl = findImplementation(name);
+	return SOABuffer<double>::paddedSize(num_points, impl == nullptr ? 0 : impl->soaAlignment);
+}
+
+ch_status ch_solve(const char* name, ch_coord_type type, void* points, size_t num_points, size_t* num_hull_points) {
+	return ch_solve_timed(name, type, points, num_points, num_hull_points, nullptr);
+}
+
+ch_status ch_solve_soa(const char* name, ch_coord_type type, void* x, void* y, size_t num_points,
+                       size_t capacity, size_t* num_hull_points) {
+	return ch_solve_soa_timed(name, type, x, y, num_points, capacity, num_hull_points, nullptr);
+}
+
+ch_status ch_solve_timed(const char* name, ch_coord_type type, void* points, size_t num_points,
+                         size_t* num_hull_points, ch_timings* timings) {
+	if (points == nullptr && num_points != 0)
+		return CH_ERROR_INVALID_ARGUMENT;
+	return runInContext(name, type, num_hull_points, timings, [&] (const HullImpl& impl, ComputeTimer& timer) -> size_t {
+		if (num_points == 0)
+			return 0;
+		if (type == CH_INT64)
+			return solveAos<int64_t>(impl, static_cast<point<int64_t>*>(points), num_points, timer);
+		return solveAos<double>(impl, static_cast<point<double>*>(points), num_points, timer);
+	});
+}
+
+ch_status ch_solve_soa_timed(const char* name, ch_coord_type type, void* x, void* y, size_t num_points,
+                             size_t capacity, size_t* num_hull_points, ch_timings* timings) {
+	if ((x == nullptr || y == nullptr) && num_points != 0)
+		return CH_ERROR_INVALID_ARGUMENT;
+	if (capacity < num_points)
+		return CH_ERROR_INVALID_ARGUMENT;
+	return runInContext(name, type, num_hull_points, timings, [&] (const HullImpl& impl, ComputeTimer& timer) -> size_t {
+		if (num_points == 0)
+			return 0;
+		if (type == CH_INT64)
+			return solveSoa<int64_t>(impl, static_cast<int64_t*>(x), static_cast<int64_t*>(y), num_points, capacity, timer);
+		return solveSoa<double>(impl, static_cast<double*>(x), static_cast<double*>(y), num_points, capacity, timer);
+	});
+}
+
+const char* ch_status_string(ch_status status) {
+	switch (status) {
+	case CH_OK: return "ok";
+	case CH_ERROR_UNKNOWN_IMPLEMENTATION: return "unknown implementation";
+	case CH_ERROR_UNSUPPORTED_TYPE: return "implementation has no version for this coordinate type";
+	case CH_ERROR_INVALID_ARGUMENT: return "invalid argument";
+	case CH_ERROR_INTERNAL: return "internal error";
+	}
+	return "unknown status";
+}
+
+}
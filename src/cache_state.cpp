@@ -0,0 +1,72 @@
+#include "cache_state.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <atomic>
+#endif
+
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Keeps the loads of loadIntoCache from being optimized away
+static volatile char cacheLoadSink;
+
+std::optional<CacheState> cacheStateFromString(std::string_view name) {
+	if (name == "unchanged")
+		return CacheState::Unchanged;
+	if (name == "cold")
+		return CacheState::Cold;
+	if (name == "warm")
+		return CacheState::Warm;
+	return std::nullopt;
+}
+
+std::string_view cacheStateName(CacheState state) {
+	switch (state) {
+	case CacheState::Unchanged: return "unchanged";
+	case CacheState::Cold: return "cold";
+	case CacheState::Warm: return "warm";
+	}
+	return "unknown";
+}
+
+static void flushFromCache(const char* begin, const char* end) {
+#if defined(__x86_64__) || defined(__i386__)
+	for (const char* line = begin; line < end; line += CACHE_LINE_SIZE) {
+		_mm_clflush(line);
+	}
+	_mm_mfence();
+#else
+	(void)begin;
+	(void)end;
+	static std::vector<char> evictionBuffer(256 << 20);
+	for (size_t i = 0; i < evictionBuffer.size(); i += CACHE_LINE_SIZE) {
+		evictionBuffer[i]++;
+	}
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+}
+
+static void loadIntoCache(const char* begin, const char* end) {
+	char sum = 0;
+	for (const char* line = begin; line < end; line += CACHE_LINE_SIZE) {
+		sum ^= *static_cast<const volatile char*>(line);
+	}
+	cacheLoadSink = sum;
+}
+
+void prepareCacheState(CacheState state, const void* data, size_t size) {
+	if (data == nullptr || size == 0)
+		return;
+	// Start at the line holding the first byte so that a partial first line is covered too
+	const char* begin = reinterpret_cast<const char*>(reinterpret_cast<uintptr_t>(data) & ~(CACHE_LINE_SIZE - 1));
+	const char* end = static_cast<const char*>(data) + size;
+	if (state == CacheState::Cold) {
+		flushFromCache(begin, end);
+	} else if (state == CacheState::Warm) {
+		loadIntoCache(begin, end);
+	}
+}
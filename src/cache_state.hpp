@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+// State the input is put in before each timed run. Unchanged leaves it as reading or restoring the input
+// left it, which for small inputs is mostly in cache and for large ones only the tail.
+enum class CacheState {
+	Unchanged,
+	Cold, // every cache line of the input is flushed to memory
+	Warm  // every cache line of the input is loaded
+};
+
+std::optional<CacheState> cacheStateFromString(std::string_view name);
+std::string_view cacheStateName(CacheState state);
+
+// Flushes or loads the size bytes at data. Flushing uses clflush where there is one and otherwise
+// evicts the input by streaming through a buffer larger than the last level cache.
+void prepareCacheState(CacheState state, const void* data, size_t size);
@@ -0,0 +1,80 @@
+#include "hull_context.hpp"
+
+#include <charconv>
+
+static thread_local HullContext* currentContext = nullptr;
+
+std::optional<int> HullContext::getArgInt(std::string_view argPrefix) const {
+	size_t pos = args.find(argPrefix);
+	if (pos != std::string::npos) {
+		int value;
+		if (std::from_chars(args.data() + pos + argPrefix.size(), args.data() + args.size(), value).ec == std::errc())
+			return value;
+	}
+	return {};
+}
+
+void HullContext::addIntermediateTime(std::string_view name) {
+	auto time = std::chrono::high_resolution_clock::now();
+	std::lock_guard<std::mutex> lock(intermediateTimesMutex);
+	intermediateTimes.emplace_back(name, time);
+}
+
+std::vector<IntermediateTime> HullContext::getIntermediateTimes() const {
+	std::lock_guard<std::mutex> lock(intermediateTimesMutex);
+	return intermediateTimes;
+}
+
+void HullContext::clearIntermediateTimes() {
+	std::lock_guard<std::mutex> lock(intermediateTimesMutex);
+	intermediateTimes.clear();
+}
+
+void HullContext::addOpCounts(const OpCounts& counts) {
+	std::lock_guard<std::mutex> lock(opCountsMutex);
+	opCounts.add(counts);
+}
+
+void HullContext::collectOpCountsOfThisThread() {
+#ifdef OP_COUNTERS
+	addOpCounts(threadOpCounts);
+	size_t depth = threadOpCounts.depth;
+	threadOpCounts = {};
+	threadOpCounts.depth = depth;
+#endif
+}
+
+OpCounts HullContext::getOpCounts() const {
+	std::lock_guard<std::mutex> lock(opCountsMutex);
+	return opCounts;
+}
+
+void HullContext::clearOpCounts() {
+	std::lock_guard<std::mutex> lock(opCountsMutex);
+	opCounts = {};
+}
+
+HullContextScope::HullContextScope(HullContext& context) : previous(currentContext) {
+	currentContext = &context;
+#ifdef OP_COUNTERS
+	// Counts made under the new context start from zero and are handed to it when the scope ends
+	outerOpCounts = threadOpCounts;
+	threadOpCounts = {};
+#endif
+}
+
+HullContextScope::~HullContextScope() {
+#ifdef OP_COUNTERS
+	currentContext->addOpCounts(threadOpCounts);
+	threadOpCounts = outerOpCounts;
+#endif
+	currentContext = previous;
+}
+
+HullContext& currentHullContext() {
+	if (currentContext == nullptr) {
+		static thread_local HullContext defaultContext;
+		return defaultContext;
+	}
+	return *currentContext;
+}
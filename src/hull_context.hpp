@@ -0,0 +1,80 @@
+#pragma once
+
+#include "op_counters.hpp"
+#include "thread_phases.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using IntermediateTime = std::pair<std::string_view, std::chrono::high_resolution_clock::time_point>;
+
+// State belonging to one solve: the implementation arguments (the part after ':' in "name:args")
+// and the intermediate times recorded while it runs. Every solve that may run concurrently with
+// another one gets its own context, so solves in a server or library do not share anything.
+//
+// Implementations reach the context of the solve they are running for through currentHullContext(),
+// which a HullContextScope sets for the calling thread. Code that hands work to other threads
+// propagates the context with a scope on each of them.
+struct HullContext {
+	std::string args;
+	
+	HullContext() = default;
+	explicit HullContext(std::string_view argsString) : args(argsString) { }
+	HullContext(const HullContext&) = delete;
+	HullContext& operator=(const HullContext&) = delete;
+	
+	std::optional<int> getArgInt(std::string_view argPrefix) const;
+	
+	// May be called from every thread working on the solve
+	void addIntermediateTime(std::string_view name);
+	std::vector<IntermediateTime> getIntermediateTimes() const;
+	void clearIntermediateTimes();
+	
+	mutable std::mutex intermediateTimesMutex;
+	std::vector<IntermediateTime> intermediateTimes;
+	
+	// Per thread phase totals, collected when threadPhases.enabled is set
+	ThreadPhases threadPhases;
+	
+	// Operation counts of the threads that worked on the solve, gathered when built with OP_COUNTERS.
+	// Threads add their counts when their HullContextScope ends, collectOpCountsOfThisThread adds
+	// those of a thread whose scope is still open.
+	void addOpCounts(const OpCounts& counts);
+	void collectOpCountsOfThisThread();
+	OpCounts getOpCounts() const;
+	void clearOpCounts();
+	
+	mutable std::mutex opCountsMutex;
+	OpCounts opCounts {};
+};
+
+// Makes context the current context of the calling thread until the scope ends
+struct HullContextScope {
+	HullContext* previous;
+#ifdef OP_COUNTERS
+	OpCounts outerOpCounts;
+#endif
+
+	explicit HullContextScope(HullContext& context);
+	~HullContextScope();
+	HullContextScope(const HullContextScope&) = delete;
+	HullContextScope& operator=(const HullContextScope&) = delete;
+};
+
+// The context set by the innermost HullContextScope of this thread, or an empty per-thread context
+HullContext& currentHullContext();
+
+#ifndef NO_PHASE_TIMERS
+inline PhaseScope::PhaseScope(std::string_view _name) : name(_name) {
+	ThreadPhases& threadPhases = currentHullContext().threadPhases;
+	if (threadPhases.enabled) {
+		record = &threadPhases.recordOfThisThread();
+		start();
+	}
+}
+#endif
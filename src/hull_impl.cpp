@@ -1,13 +1,10 @@
 #include "hull_impl.hpp"
 
-#include <charconv>
 #include <chrono>
 #include <iostream>
 
 std::vector<HullImpl>* hullImplementations;
 
-std::string_view implArgs;
-
 int _defHullImpl(HullImpl impl) {
 	if (hullImplementations == nullptr) {
 		hullImplementations = new std::vector<HullImpl>;
@@ -17,22 +14,15 @@ int _defHullImpl(HullImpl impl) {
 }
 
 std::optional<int> getImplArgInt(std::string_view argPrefix) {
-	size_t pos = implArgs.find(argPrefix);
-	if (pos != std::string_view::npos) {
-		int value;
-		if (std::from_chars(implArgs.data() + pos + argPrefix.size(), implArgs.data() + implArgs.size(), value).ec == std::errc())
-			return value;
-	}
-	return {};
+	return currentHullContext().getArgInt(argPrefix);
 }
 
-static std::vector<std::pair<std::string_view, std::chrono::high_resolution_clock::time_point>> intermediateTimes;
-
 void addIntermediateTime(std::string_view name) {
-	intermediateTimes.emplace_back(name, std::chrono::high_resolution_clock::now());
+	currentHullContext().addIntermediateTime(name);
 }
 
 void printIntermediateTimes(std::chrono::high_resolution_clock::time_point startTime) {
+	std::vector<IntermediateTime> intermediateTimes = currentHullContext().getIntermediateTimes();
 	if (intermediateTimes.empty())
 		return;
 	std::cerr << "intermediate times:\n";
@@ -7,6 +7,7 @@
 
 #include "point.hpp"
 #include "soa_points.hpp"
+#include "hull_context.hpp"
 
 template <typename T>
 using HullSolveFunction = std::function<void(std::vector<point<T>>&)>;
@@ -25,8 +26,10 @@ struct HullImpl {
 
 extern std::vector<HullImpl>* hullImplementations;
 
-extern std::string_view implArgs;
+// Fewest points every implementation handles, most index the first three points unchecked
+constexpr size_t MIN_HULL_POINTS = 3;
 
+// Shorthands for the current HullContext
 std::optional<int> getImplArgInt(std::string_view argPrefix);
 
 int _defHullImpl(HullImpl impl);
@@ -11,6 +11,7 @@ static bool Hull2D(std::vector<point<T>>& pts, long long m, long long H, bool us
     long long numsets = (pts.size() + m - 1)/m; // Number of partitions, ceil(n/m)
 
     // Division of the points into sets of size m and run O(nlogn) algorithm on each set.
+    PhaseScope phase("subhulls");
     std::vector<std::span<point<T>>> spans;
     for (long long i = 0; i < numsets; i++) {
         long long start = i*m;
@@ -21,6 +22,7 @@ static bool Hull2D(std::vector<point<T>>& pts, long long m, long long H, bool us
         spans.push_back(current_span);
     }
     
+    phase.switchTo("merge");
     std::vector<point<T>> result(H+1);
     long long try_size = Merge2DHulls(spans, result, 0, H);
     if (try_size > -1) {
@@ -31,6 +33,7 @@ static bool Hull2D(std::vector<point<T>>& pts, long long m, long long H, bool us
 
     if (use_idea_1) {
         // Refinement idea 1 from chans paper, remove known interior points from further consideration.
+        phase.switchTo("compaction");
         std::vector<point<T>> temp;
         for (long long i = 0; i < numsets; i++) {
             std::copy(spans[i].begin(), spans[i].end(), std::back_inserter(temp));
@@ -49,6 +52,7 @@ static void runChan(std::vector<point<T>>& pts, bool use_idea_1, bool use_idea_2
         // Refinement idea 2 from chans paper, put H = m/logm
         long long H = std::min((long long) pts.size(), calcH(t, use_idea_2)); // 2ˆ2ˆt (/2ˆt if use_idea_2) 
         long long m = calcM(t); // 2ˆ2ˆt
+        PhaseScope phase("iteration");
         if (Hull2D(pts, m, H, use_idea_1)) {
             return;
         }
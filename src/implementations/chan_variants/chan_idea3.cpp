@@ -22,6 +22,7 @@ static void runChanId3(std::vector<point<T>>& pts1, size_t exponent, bool use_id
     long long current_set_size = m;
 
     long long numsets = (pts1.size() + current_set_size - 1)/current_set_size; // Number of partitions, ceil(n/m)
+    PhaseScope subhullsPhase("subhulls");
     std::vector<std::span<point<T>>> spans;
     for (long long i = 0; i < numsets; i++) {
         long long start = i*current_set_size;
@@ -33,14 +34,19 @@ static void runChanId3(std::vector<point<T>>& pts1, size_t exponent, bool use_id
         }
         spans.push_back(current_span);
     }
+    subhullsPhase.stop();
     std::vector<point<T>> pts2(pts1.size()); // Assert that pts2 never has to move the data. This would cause the spans to be invalid.
 
     std::vector<point<T>> *a = &pts1, *b = &pts2; // a always points to vector currently containing the points.
     bool pts1_has_spans = true;
+    BreadthFirstLevels levels;
     while (spans.size() > 1) {
         t++;
         m = calcM(t);
+        PhaseScope iterationPhase("iteration");
         while (current_set_size < m && spans.size() > 1) {
+            PhaseScope phase("pairwise merge");
+            levels.next();
             pairwiseMerge(spans, exponent, *b); // Move spans from a to b
             //a->clear();
             std::swap(a,b);
@@ -50,7 +56,11 @@ static void runChanId3(std::vector<point<T>>& pts1, size_t exponent, bool use_id
         if (spans.size() == 1) break; // Early break to avoid unnecessary computations
 
         long long H = calcH(t, use_idea_2); // 2^2^t or 2^(2^t-t)
-        long long try_size = Merge2DHulls(spans, *b, 0, H);
+        long long try_size;
+        {
+            PhaseScope phase("merge");
+            try_size = Merge2DHulls(spans, *b, 0, H);
+        }
         if (try_size > -1) {
             pts1_has_spans = !pts1_has_spans;
             if (!pts1_has_spans) {
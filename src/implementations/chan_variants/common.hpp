@@ -66,6 +66,7 @@ inline long long Merge2DHulls(std::vector<std::span<point<T>>>& spans, std::vect
                 side orientation = cur.sideOfLine(next, prevHullPoint);
                 if (orientation == side::right || (orientation == side::on && (cur - prevHullPoint).lenmh() < (next - prevHullPoint).lenmh())) {
                     indices[pi]++;
+                    countOp(OpCounter::TangentSteps);
                 } else {
                     break;
                 }
@@ -103,6 +104,7 @@ inline long long Merge2DHulls(std::vector<std::span<point<T>>>& spans, std::vect
         output_size++;
         indices[lastHullUsed]++;
     }
+    countOp(OpCounter::FailedHullGuesses);
     return -1;
 }
 
@@ -118,6 +120,14 @@ inline void pairwiseMerge(std::vector<std::span<point<T>>>& spans, size_t expone
     std::vector<std::span<point<T>>> output;
     std::vector<std::span<point<T>>> temp;
     long long b_start = 0;
+    auto numPoints = [] (const std::vector<std::span<point<T>>>& hulls) {
+        size_t sum = 0;
+        for (const auto& hull : hulls) {
+            sum += hull.size();
+        }
+        return sum;
+    };
+    size_t numPointsBefore = numPoints(spans);
     for (size_t i = 0; i < spans.size(); i++) {
         temp.push_back(std::move(spans[i]));
         if (temp.size() == exponent) {
@@ -139,6 +149,7 @@ inline void pairwiseMerge(std::vector<std::span<point<T>>>& spans, size_t expone
             output.push_back(std::span<point<T>>(b.begin()+b_start, b.begin()+b_start+size));
         }
     }
+    countDiscarded(numPointsBefore - numPoints(output));
     spans = std::move(output);
 }
 
@@ -26,11 +26,14 @@ static void runMergeHull(std::vector<point<T>>& pts1, size_t exponent, bool redu
         // current_span = current_span.subspan(0,newsize);
         spans.push_back(current_span);
     }
+    BreadthFirstLevels levels;
     if (reduce_copy) { // Allocate 2 vectors, and alternatively read from one and write to the other. Less copying of data
         std::vector<point<T>> pts2(pts1.size()); // Make sure that pts2 never has to reallocate the data. This would cause the spans to become invalid.
         std::vector<point<T>> *a = &pts1, *b = &pts2; // a always points to vector currently containing the points.
         bool pts1_has_spans = true;
         while (spans.size() > 1) {
+            PhaseScope phase("pairwise merge");
+            levels.next();
             pairwiseMerge(spans, exponent, *b); // Spans move from a to b
             // a->clear();
             std::swap(a,b); 
@@ -42,6 +45,8 @@ static void runMergeHull(std::vector<point<T>>& pts1, size_t exponent, bool redu
     } else { // Simple implementation. Computed hulls are temporarily written to temp and then back to pts vector.
         std::vector<point<T>> temp(pts1.size()); // Hulls are temporarily written here when computed.
         while (spans.size() > 1) {
+            PhaseScope phase("pairwise merge");
+            levels.next();
             pairwiseMerge(spans, exponent, temp, true);
         }
     }
@@ -28,15 +28,25 @@ static void runMergeHullChanTrick(std::vector<point<T>>& pts1, size_t exponent)
 
     std::vector<point<T>> *a = &pts1, *b = &pts2; // a always points to vector currently containing the points.
     bool pts1_has_spans = true;
+    BreadthFirstLevels levels;
     while (spans.size() > 1) { // This will loop min(log(n), 2*log(h)) times
-        pairwiseMerge(spans, exponent, *b); // Move spans from a to b
+        PhaseScope iterationPhase("iteration");
+        {
+            PhaseScope phase("pairwise merge");
+            levels.next();
+            pairwiseMerge(spans, exponent, *b); // Move spans from a to b
+        }
         //a->clear();
         std::swap(a,b);
         pts1_has_spans = !pts1_has_spans;
         current_set_size *= exponent;
 
         long long H = ceil(sqrt(current_set_size));
-        long long try_size = Merge2DHulls(spans, *b, 0, H);
+        long long try_size;
+        {
+            PhaseScope phase("merge");
+            try_size = Merge2DHulls(spans, *b, 0, H);
+        }
         if (try_size > -1) {
             pts1_has_spans = !pts1_has_spans;
             if (!pts1_has_spans) {
@@ -1,3 +1,4 @@
+#include "dc_preparata_hong.hpp"
 #include "../hull_impl.hpp"
 #include "../point.hpp"
 
@@ -35,11 +36,13 @@ std::pair<size_t,size_t> find_tangent(std::span<point<T>> A, std::span<point<T>>
 			// If we are building lower tangent we want to lower the line (turn left) and vice versa.
 			if ((orientationA == side::left && lowerTangent) || (orientationA == side::right && !lowerTangent)) { 
 				i = nexti;
+				countOp(OpCounter::TangentSteps);
 				continue;
 			} 
 			// If colinear pick furthest point from B[j]
 			if (orientationA == side::on && (A[i]-B[j]).len2() < (A[nexti]-B[j]).len2()) {
 				i = nexti;
+				countOp(OpCounter::TangentSteps);
 				continue;
 			}
 		}
@@ -49,10 +52,12 @@ std::pair<size_t,size_t> find_tangent(std::span<point<T>> A, std::span<point<T>>
 			// If we are building lower tangent we want to lower the line (turn right) and vice versa.
 			if ((orientationB == side::right && lowerTangent) || (orientationB == side::left && !lowerTangent)) {
 				j = nextj; 
+				countOp(OpCounter::TangentSteps);
 				continue;
 			}
 			if (orientationB == side::on && (B[j]-A[i]).len2() < (B[nextj]-A[i]).len2()) {
 				j = nextj;
+				countOp(OpCounter::TangentSteps);
 				continue;
 			}
 		}
@@ -62,11 +67,13 @@ std::pair<size_t,size_t> find_tangent(std::span<point<T>> A, std::span<point<T>>
 			// If we are building lower tangent we want to lower the line (turn left) and vice versa.
 			if ((orientationA == side::left && lowerTangent) || (orientationA == side::right && !lowerTangent)) { 
 				i = nexti;
+				countOp(OpCounter::TangentSteps);
 				continue;
 			} 
 			// If colinear pick furthest point from B[j]
 			if (orientationA == side::on && (A[i]-B[j]).len2() < (A[nexti]-B[j]).len2()) {
 				i = nexti;
+				countOp(OpCounter::TangentSteps);
 				continue;
 			}
 		}
@@ -76,6 +83,9 @@ std::pair<size_t,size_t> find_tangent(std::span<point<T>> A, std::span<point<T>>
 	return std::make_pair(i,j);
 }
 
+template std::pair<size_t,size_t> find_tangent<int64_t>(std::span<point<int64_t>> A, std::span<point<int64_t>> B, size_t sA, size_t sB, bool lowerTangent);
+template std::pair<size_t,size_t> find_tangent<double>(std::span<point<double>> A, std::span<point<double>> B, size_t sA, size_t sB, bool lowerTangent);
+
 // Returns number of points on hull
 template <typename T>
 size_t ch(std::span<point<T>> pts) {
@@ -98,6 +108,7 @@ size_t ch(std::span<point<T>> pts) {
 		return n;
 	}
 
+	RecursionLevel level;
 	std::span<point<T>> A = pts.subspan(0,n/2);
 	std::span<point<T>> B = pts.subspan(n/2,n-n/2);
 	size_t szA = ch(A);
@@ -155,6 +166,7 @@ size_t ch(std::span<point<T>> pts) {
 		size++;
 	}
 
+	countDiscarded(szA + szB - size);
 	return size;
 	
 }
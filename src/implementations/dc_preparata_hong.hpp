@@ -0,0 +1,9 @@
+#pragma once
+
+#include "../point.hpp"
+
+#include <span>
+#include <utility>
+
+template <typename T>
+std::pair<size_t,size_t> find_tangent(std::span<point<T>> A, std::span<point<T>> B, size_t sA, size_t sB, bool lowerTangent);
@@ -11,12 +11,14 @@ void runImpl1(std::vector<point<T>>& pts, bool parallelSort) {
 	if (pts.size() <= 1)
 		return;
 	
+	PhaseScope phase("sort");
 	if (parallelSort) {
 		std::sort(std::execution::par, pts.begin(), pts.end());
 	} else {
 		std::sort(pts.begin(), pts.end());
 	}
 	
+	phase.switchTo("merge");
 	std::vector<point<T>> h;
 	auto f = [&] (size_t s) {
 		for (auto p : pts) {
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "../point.hpp"
+#include "simd_utils.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+
+// Points stored as four wide vectors of x and y, the first skipFirst and last skipLast lanes unused
+struct points {
+	__m256d* x;
+	__m256d* y;
+	uint32_t vcount;
+	uint8_t skipFirst;
+	uint8_t skipLast;
+	
+	template <typename CallbackT>
+	void forEach(CallbackT callback) {
+		if (vcount == 0)
+			return;
+		uint8_t firstMask = ((1 << skipFirst) - 1) ^ 0xF;
+		uint8_t lastMask = (0x10 >> skipLast) - 1;
+		if (vcount == 1) {
+			callback(0, firstMask & lastMask);
+		} else {
+			callback(0, firstMask);
+			for (size_t i = 1; i < vcount - 1; i++) {
+				callback(i, 0xF);
+			}
+			callback(vcount - 1, lastMask);
+		}
+	}
+	
+	points subspan(uint32_t first, uint32_t count) const {
+		uint32_t ofirst = first + (uint32_t)skipFirst;
+		uint32_t oend = ofirst + count;
+		uint32_t vfirst = ofirst / 4;
+		uint32_t vend = (oend + 3) / 4;
+		return points {
+			.x = x + vfirst,
+			.y = y + vfirst,
+			.vcount = vend - vfirst,
+			.skipFirst = (uint8_t)(ofirst % 4),
+			.skipLast = (uint8_t)((vend * 4) - oend)
+		};
+	}
+	
+	uint32_t count() const {
+		return vcount * 4 - (uint32_t)skipFirst - (uint32_t)skipLast;
+	}
+	
+	std::pair<double*, double*> getDoublePointers() {
+		return { reinterpret_cast<double*>(x) + skipFirst, reinterpret_cast<double*>(y) + skipFirst };
+	}
+	
+	pointd at(uint32_t i) const {
+		size_t oi = i + (uint32_t)skipFirst;
+		return { x[oi/4][oi%4], y[oi/4][oi%4] };
+	}
+	
+	void set(size_t i, pointd p) {
+		size_t oi = i + (uint32_t)skipFirst;
+		x[oi/4][oi%4] = p.x;
+		y[oi/4][oi%4] = p.y;
+	}
+	
+	void print(int prefix = 0) const {
+		std::cerr << std::string(prefix * 2, ' ');
+		for (size_t i = 0; i < count(); i++) {
+			std::cerr << at(i) << " ";
+		}
+		std::cerr << "\n";
+	}
+};
+
+inline __m256d bitmapToVecmask(int m) {
+	static const __m256i vshift_count = _mm256_set_epi64x(60, 61, 62, 63);
+	__m256i bcast = _mm256_set1_epi64x(m);
+	return _mm256_castsi256_pd(_mm256_sllv_epi64(bcast, vshift_count));
+}
+
+template <bool KeepLeft>
+size_t partitionByLine(points pts, pointd lineStart, pointd lineEnd) {
+	const auto lineStartX4 = _mm256_set1_pd(lineStart.x);
+	const auto lineStartY4 = _mm256_set1_pd(lineStart.y);
+	const auto lineDeltaX4 = _mm256_set1_pd(lineEnd.x - lineStart.x);
+	const auto lineDeltaY4 = _mm256_set1_pd(lineEnd.y - lineStart.y);
+	
+	size_t numRight = 0;
+	
+	auto [ptsxd, ptsyd] = pts.getDoublePointers();
+	
+	pts.forEach([&] (size_t vi, uint32_t activeCompMask) {
+		uint32_t mask = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(
+			_mm256_mul_pd(_mm256_sub_pd(pts.y[vi], lineStartY4), lineDeltaX4),
+			_mm256_mul_pd(_mm256_sub_pd(pts.x[vi], lineStartX4), lineDeltaY4),
+			_CMP_LT_OQ
+		))) & activeCompMask;
+		
+		for (uint32_t j = 0; j < 4; j++) {
+			if (mask & ((uint32_t)1 << j)) {
+				if (KeepLeft) {
+					std::swap(ptsxd[numRight], pts.x[vi][j]);
+					std::swap(ptsyd[numRight], pts.y[vi][j]);
+				} else {
+					ptsxd[numRight] = pts.x[vi][j];
+					ptsyd[numRight] = pts.y[vi][j];
+				}
+				numRight++;
+			}
+		}
+	});
+	
+	return numRight;
+}
+
+inline int findMaxPointIndex(points pts, pointd offsetPoint, pointd normal) {
+	const auto normalX4 = _mm256_set1_pd(normal.x);
+	const auto normalY4 = _mm256_set1_pd(normal.y);
+	const auto offsetX4 = _mm256_set1_pd(offsetPoint.x);
+	const auto offsetY4 = _mm256_set1_pd(offsetPoint.y);
+	
+	__m256i indices = _mm256_setr_epi64x(0, 1, 2, 3);
+	const __m256i indicesInc = _mm256_set1_epi64x(4);
+	
+	__m256d maxDotValues = _mm256_set1_pd(-INFINITY);
+	__m256i maxIndices = _mm256_set1_epi64x(0);
+	
+	pts.forEach([&] (size_t vi, uint32_t activeCompMask) {
+		auto mulx = _mm256_mul_pd(_mm256_sub_pd(pts.x[vi], offsetX4), normalX4);
+		auto dot = _mm256_fmadd_pd(_mm256_sub_pd(pts.y[vi], offsetY4), normalY4, mulx);
+		
+		__m256d cmpResult = _mm256_cmp_pd(maxDotValues, dot, _CMP_LT_OQ);
+		cmpResult = _mm256_and_pd(cmpResult, bitmapToVecmask(activeCompMask));
+		
+		maxDotValues = _mm256_blendv_pd(maxDotValues, dot, cmpResult);
+		maxIndices = _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(maxIndices), _mm256_castsi256_pd(indices), cmpResult));
+		indices = _mm256_add_epi64(indices, indicesInc);
+	});
+	
+	alignas(__m256i) int64_t maxIndicesBuffer[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(maxIndicesBuffer), maxIndices);
+	
+	std::pair<double, int64_t> maxPoint(-INFINITY, -1);
+	for (int i = 0; i < 4; i++) {
+		maxPoint = std::max(maxPoint, std::make_pair(maxDotValues[i], maxIndicesBuffer[i]));
+	}
+	
+	return (int)maxPoint.second - (int)pts.skipFirst;
+}
@@ -42,6 +42,7 @@ namespace qh_bf {
 	
 	template <typename T>
 	void Data<T>::initialize(std::vector<point<T>>& pts) {
+		PhaseScope phase("extreme search");
 		size_t leftmost = std::min_element(pts.begin(), pts.end()) - pts.begin();
 		point<T> leftmostPt = pts[leftmost];
 		std::swap(pts.front(), pts[leftmost]);
@@ -50,6 +51,7 @@ namespace qh_bf {
 		point<T> rightmostPt = pts[rightmost];
 		std::swap(pts.back(), pts[rightmost]);
 		
+		phase.switchTo("partition");
 		auto belowPointsEndIt = std::partition(pts.begin() + 1, pts.end() - 1, [&] (const point<T>& p) -> bool {
 			return p.sideOfLine(leftmostPt, rightmostPt) == side::right;
 		});
@@ -64,6 +66,7 @@ namespace qh_bf {
 	
 	template <typename T>
 	void Data<T>::compactAndRemoveNotOnHull(std::vector<point<T>>& pts) {
+		PhaseScope phase("compaction");
 		uint32_t numPointsKept = 0;
 		uint32_t prevHi = 0;
 		
@@ -97,7 +100,10 @@ namespace qh_bf {
 	
 	template <qhPartitionStrategy S, typename T>
 	void run_alwaysCompact(std::vector<point<T>>& pts, Data<T>& data) {
+		BreadthFirstLevels levels;
 		while (!data.intervals.empty()) {
+			levels.next();
+			PhaseScope iterationPhase("iteration");
 			uint32_t nextOutIdx = data.intervals[0].first;
 			
 			for (size_t ii = 0; ii < data.intervals.size(); ii++) {
@@ -108,8 +114,13 @@ namespace qh_bf {
 				
 				std::span<point<T>> ptsSpan(pts.data() + ilo, pts.data() + ihi);
 				
-				size_t maxPointIdx = findFurthestPointFromLine<T>(ptsSpan, leftHullPoint, rightHullPoint);
+				size_t maxPointIdx;
+				{
+					PhaseScope phase("extreme search");
+					maxPointIdx = findFurthestPointFromLine<T>(ptsSpan, leftHullPoint, rightHullPoint);
+				}
 				
+				PhaseScope phase("partition");
 				if (ptsSpan[maxPointIdx].sideOfLine(leftHullPoint, rightHullPoint) == side::left) {
 					if (ihi == ilo + 1) {
 						pts[nextOutIdx++] = pts[ilo];
@@ -131,6 +142,8 @@ namespace qh_bf {
 						data.addInterval(rightIntvLo, rightIntvHi);
 						data.addInterval(leftIntvLo, leftIntvHi);
 					}
+				} else {
+					countDiscarded(ihi - ilo);
 				}
 				
 				uint32_t nextIntvLo = ii == data.intervals.size() - 1 ? pts.size() : data.intervals[ii + 1].first;
@@ -145,6 +158,7 @@ namespace qh_bf {
 	
 	template <qhPartitionStrategy S, typename T>
 	int runSingleStepWithoutCompaction(std::vector<point<T>>& pts, Data<T>& data) {
+		PhaseScope iterationPhase("iteration");
 		int numNotCompacted = 0;
 		for (size_t ii = 0; ii < data.intervals.size(); ii++) {
 			auto [ilo, ihi] = data.intervals[ii];
@@ -160,11 +174,17 @@ namespace qh_bf {
 			
 			std::span<point<T>> ptsSpan(pts.data() + ilo, pts.data() + ihi);
 			
-			size_t maxPointIdx = findFurthestPointFromLine<T>(ptsSpan, leftHullPoint, rightHullPoint);
+			size_t maxPointIdx;
+			{
+				PhaseScope phase("extreme search");
+				maxPointIdx = findFurthestPointFromLine<T>(ptsSpan, leftHullPoint, rightHullPoint);
+			}
 			
+			PhaseScope phase("partition");
 			//If the max point is not outside the line between the left and right hull point,
 			// remove all points in this interval
 			if (pts[ilo + maxPointIdx].sideOfLine(leftHullPoint, rightHullPoint) != side::left) {
+				countDiscarded(ihi - ilo);
 				numNotCompacted += ihi - ilo;
 				std::fill(pts.begin() + ilo, pts.begin() + ihi, point<T>::notOnHull);
 				continue;
@@ -195,7 +215,9 @@ namespace qh_bf {
 		Data<T> data;
 		data.initialize(pts);
 		
+		BreadthFirstLevels levels;
 		while (!data.intervals.empty()) {
+			levels.next();
 			numNotCompacted += runSingleStepWithoutCompaction<S>(pts, data);
 			if (numNotCompacted > compactPointThreshold) {
 				data.compactAndRemoveNotOnHull(pts);
@@ -203,6 +225,7 @@ namespace qh_bf {
 			}
 		}
 		if (numNotCompacted > 0) {
+			PhaseScope phase("compaction");
 			removeNotOnHull(pts);
 		}
 	}
@@ -214,13 +237,17 @@ namespace qh_bf {
 		Data<T> data;
 		data.initialize(pts);
 		
+		BreadthFirstLevels levels;
 		for (int depth = 0; depth < compactDepthThreshold && !data.intervals.empty(); depth++) {
+			levels.next();
 			numNotCompacted += runSingleStepWithoutCompaction<S>(pts, data);
 		}
 		
 		if (data.intervals.empty()) {
-			if (numNotCompacted > 0)
+			if (numNotCompacted > 0) {
+				PhaseScope phase("compaction");
 				removeNotOnHull(pts);
+			}
 			return;
 		}
 		
@@ -234,7 +261,7 @@ namespace qh_bf {
 	
 	template <qhPartitionStrategy S, typename T>
 	void run(std::vector<point<T>>& pts) {
-		if (implArgs == "N") {
+		if (currentHullContext().args == "N") {
 			run_pointThresholdCompact<S>(pts, std::numeric_limits<int>::max());
 		} else if (int pointsThresholdOpt = getImplArgInt("P").value_or(0)) {
 			run_pointThresholdCompact<S>(pts, pointsThresholdOpt);
@@ -24,21 +24,25 @@ template <typename execution_policy>
 void quickhullParallel(std::vector<pointd>& pts, bool removePoints) {
 	execution_policy ep;
 	
+	PhaseScope phase("extreme search");
 	auto [itMin, itMax] = std::minmax_element(ep, pts.begin(), pts.end());
 	
 	pointd allMinPt = *itMin;
 	pointd allMaxPt = *itMax;
 	
 	//Moves points so that points below the line come first
+	phase.switchTo("partition");
 	auto itFirstAbove = std::partition(ep, pts.begin(), pts.end(), [&] (const pointd& p) {
 		return p.sideOfLine(allMinPt, allMaxPt, 0.00001) != side::left;
 	});
 	uint32_t numBelow = itFirstAbove - pts.begin();
 	
 	//Sorts points by X. Increasing below the first line, and decreasing above
+	phase.switchTo("sort");
 	std::sort(ep, pts.begin(), itFirstAbove, [] (const auto& a, const auto& b) { return a < b; });
 	std::sort(ep, itFirstAbove, pts.end(), [] (const auto& a, const auto& b) { return a > b; });
 	
+	phase.stop();
 	uint32_t allMaxPtIdx = numBelow - 1;
 	assert(pts[0] == allMinPt);
 	assert(pts[allMaxPtIdx] == allMaxPt);
@@ -58,6 +62,7 @@ void quickhullParallel(std::vector<pointd>& pts, bool removePoints) {
 	uint32_t numPoints = pts.size();
 	
 	auto removePointsInHull = [&] () {
+		PhaseScope compactionPhase("compaction");
 		std::transform_inclusive_scan(ep,
 			adjHullPoints.begin(), adjHullPoints.begin() + numPoints,
 			&numRemovePrefixSum[1], std::plus<>(),
@@ -90,6 +95,7 @@ void quickhullParallel(std::vector<pointd>& pts, bool removePoints) {
 	addIntermediateTime("init");
 	
 	do {
+		phase.switchTo("extreme search");
 		std::transform_inclusive_scan(ep,
 			makeCountingIterator(0), makeCountingIterator(numPoints), &distsPrefixMax[0],
 			[&] (const auto& a, const auto& b) { return std::max(a, b); },
@@ -106,6 +112,7 @@ void quickhullParallel(std::vector<pointd>& pts, bool removePoints) {
 		
 		anyPointActive = false;
 		
+		phase.switchTo("partition");
 		std::for_each(ep,
 			makeCountingIterator(0), makeCountingIterator(numPoints),
 			[&] (uint32_t idx) {
@@ -136,6 +143,8 @@ void quickhullParallel(std::vector<pointd>& pts, bool removePoints) {
 			}
 		);
 		
+		phase.stop();
+		
 		if (removePoints)
 			removePointsInHull();
 	} while (anyPointActive);
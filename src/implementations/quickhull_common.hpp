@@ -2,6 +2,8 @@
 
 #include "../point.hpp"
 
+#include <algorithm>
+#include <array>
 #include <span>
 
 template <typename T>
@@ -23,6 +25,30 @@ size_t findFurthestPointFromLine(std::span<const point<T>> pts, point<T> lineSta
 	return maxPointIdx;
 }
 
+// std::partition, counting the points it moves when operation counters are compiled in.
+// The counting version is the same swap-from-both-ends algorithm libstdc++ uses for bidirectional iterators.
+template <typename It, typename Pred>
+It qhPartition(It first, It last, Pred pred) {
+#ifdef OP_COUNTERS
+	while (true) {
+		while (first != last && pred(*first))
+			++first;
+		if (first == last)
+			return first;
+		do {
+			--last;
+			if (first == last)
+				return first;
+		} while (!pred(*last));
+		std::iter_swap(first, last);
+		countOp(OpCounter::PartitionMoves, 2);
+		++first;
+	}
+#else
+	return std::partition(first, last, pred);
+#endif
+}
+
 enum class qhPartitionStrategy {
 	noPartitionByX,
 	firstPartitionByX,
@@ -38,6 +64,7 @@ std::array<std::span<point<T>>, 2> quickhullPartitionPoints(
 ) {
 	point<T> maxPoint = pts[midHullPointIdx];
 	std::swap(pts[midHullPointIdx], pts.back());
+	countOp(OpCounter::PartitionMoves, 2);
 	
 	size_t numPointsRight, numPointsNotLeft;
 	
@@ -51,8 +78,10 @@ std::array<std::span<point<T>>, 2> quickhullPartitionPoints(
 		for (size_t i = numPointsRight; i < numPointsNotLeft;) {
 			if (pts[i].sideOfLine(rightHullPoint, maxPoint) == side::right) {
 				std::swap(pts[numPointsRight++], pts[i++]);
+				countOp(OpCounter::PartitionMoves, 2);
 			} else if (pts[i].sideOfLine(maxPoint, leftHullPoint) == side::right) {
 				std::swap(pts[--numPointsNotLeft], pts[i]);
+				countOp(OpCounter::PartitionMoves, 2);
 			} else {
 				if constexpr (WriteNotOnHull) {
 					pts[i] = point<T>::notOnHull;
@@ -62,7 +91,9 @@ std::array<std::span<point<T>>, 2> quickhullPartitionPoints(
 		}
 		
 		std::swap(pts[numPointsNotLeft], pts.back());
+		countOp(OpCounter::PartitionMoves, 2);
 		midHullPointIdx = numPointsNotLeft;
+		countDiscarded(numPointsNotLeft - numPointsRight);
 		
 		return { pts.subspan(0, numPointsRight), pts.subspan(numPointsNotLeft + 1) };
 	}
@@ -70,11 +101,11 @@ std::array<std::span<point<T>>, 2> quickhullPartitionPoints(
 	if constexpr (S == qhPartitionStrategy::firstPartitionByX) {
 		bool upperHull = leftHullPoint < rightHullPoint;
 		
-		auto rightPointsEndIt = std::partition(pts.begin(), pts.end() - 1, [&] (const point<T>& p) -> bool {
+		auto rightPointsEndIt = qhPartition(pts.begin(), pts.end() - 1, [&] (const point<T>& p) -> bool {
 			return (p.x < maxPoint.x) ^ upperHull;
 		});
 		
-		auto rightPointsValidEndIt = std::partition(pts.begin(), rightPointsEndIt, [&] (const point<T>& p) -> bool {
+		auto rightPointsValidEndIt = qhPartition(pts.begin(), rightPointsEndIt, [&] (const point<T>& p) -> bool {
 			return p.sideOfLine(rightHullPoint, maxPoint) == side::right;
 		});
 		
@@ -85,7 +116,7 @@ std::array<std::span<point<T>>, 2> quickhullPartitionPoints(
 		numPointsNotLeft = rightPointsEndIt - pts.begin();
 		numPointsRight = rightPointsValidEndIt - pts.begin();
 	} else {
-		auto rightPointsEndIt = std::partition(pts.begin(), pts.end() - 1, [&] (const point<T>& p) -> bool {
+		auto rightPointsEndIt = qhPartition(pts.begin(), pts.end() - 1, [&] (const point<T>& p) -> bool {
 			return p.sideOfLine(rightHullPoint, maxPoint) == side::right;
 		});
 		
@@ -93,10 +124,11 @@ std::array<std::span<point<T>>, 2> quickhullPartitionPoints(
 	}
 	
 	std::swap(pts[numPointsNotLeft], pts.back());
+	countOp(OpCounter::PartitionMoves, 2);
 	midHullPointIdx = numPointsNotLeft;
 	
 	auto leftPointsBeginIt = pts.begin() + numPointsNotLeft + 1;
-	auto leftPointsEndIt = std::partition(leftPointsBeginIt, pts.end(), [&] (const point<T>& p) -> bool {
+	auto leftPointsEndIt = qhPartition(leftPointsBeginIt, pts.end(), [&] (const point<T>& p) -> bool {
 		return p.sideOfLine(maxPoint, leftHullPoint) == side::right;
 	});
 	
@@ -105,6 +137,7 @@ std::array<std::span<point<T>>, 2> quickhullPartitionPoints(
 	}
 	
 	size_t numPointsLeft = leftPointsEndIt - leftPointsBeginIt;
+	countDiscarded(pts.size() - 1 - numPointsRight - numPointsLeft);
 	
 	return { pts.subspan(0, numPointsRight), pts.subspan(numPointsNotLeft + 1, numPointsLeft) };
 }
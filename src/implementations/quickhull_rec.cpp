@@ -12,10 +12,12 @@ static void quickhullRec(std::span<point<T>> pts, point<T> leftHullPoint, point<
 	if (pts.empty())
 		return;
 	
+	RecursionLevel level;
 	size_t maxPointIdx = findFurthestPointFromLine<T>(pts, leftHullPoint, rightHullPoint);
 	point<T> maxPoint = pts[maxPointIdx];
 	
 	if (pts[maxPointIdx].sideOfLine(leftHullPoint, rightHullPoint) != side::left) {
+		countDiscarded(pts.size());
 		std::fill(pts.begin(), pts.end(), point<T>::notOnHull);
 		return;
 	}
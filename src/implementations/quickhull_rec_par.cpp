@@ -9,6 +9,7 @@
 #include <thread>
 #include <list>
 #include <mutex>
+#include <array>
 
 struct ParallelData {
 	std::mutex lock;
@@ -17,8 +18,15 @@ struct ParallelData {
 	template <typename CB>
 	void maybeRunInParallel(bool parallel, CB callback) {
 		if (parallel) {
+			HullContext& context = currentHullContext();
+			size_t depth = currentRecursionDepth();
 			lock.lock();
-			threads.emplace_back(callback);
+			threads.emplace_back([&context, depth, callback] {
+				HullContextScope contextScope(context);
+				setRecursionDepth(depth);
+				PhaseScope phase("task");
+				callback();
+			});
 			lock.unlock();
 		} else {
 			callback();
@@ -34,10 +42,17 @@ void quickhullRecPar(
 	if (pts.empty())
 		return;
 	
-	size_t maxPointIdx = findFurthestPointFromLine<T>(pts, leftHullPoint, rightHullPoint);
+	RecursionLevel level;
+	size_t maxPointIdx;
+	{
+		PhaseScope phase("extreme search");
+		maxPointIdx = findFurthestPointFromLine<T>(pts, leftHullPoint, rightHullPoint);
+	}
 	point<T> maxPoint = pts[maxPointIdx];
 	
 	if (pts[maxPointIdx].sideOfLine(leftHullPoint, rightHullPoint) != side::left) {
+		PhaseScope phase("compaction");
+		countDiscarded(pts.size());
 		std::fill(pts.begin(), pts.end(), point<T>::notOnHull);
 		return;
 	}
@@ -45,7 +60,12 @@ void quickhullRecPar(
 	if (pts.size() == 1)
 		return;
 	
-	auto [rightSubspan, leftSubspan] = quickhullPartitionPoints<S, T>(pts, leftHullPoint, rightHullPoint, maxPointIdx);
+	std::array<std::span<point<T>>, 2> subspans;
+	{
+		PhaseScope phase("partition");
+		subspans = quickhullPartitionPoints<S, T>(pts, leftHullPoint, rightHullPoint, maxPointIdx);
+	}
+	auto [rightSubspan, leftSubspan] = subspans;
 	
 	auto pdataPtr = &pdata;
 	pdata.maybeRunInParallel(remParallelDepth > 0, [=] {
@@ -57,6 +77,7 @@ void quickhullRecPar(
 
 template <qhPartitionStrategy S, typename T>
 void runQuickhullPar(std::vector<point<T>>& pts) {
+	PhaseScope phase("extreme search");
 	size_t leftmost = std::min_element(pts.begin(), pts.end()) - pts.begin();
 	point<T> leftmostPt = pts[leftmost];
 	std::swap(pts.front(), pts[leftmost]);
@@ -65,11 +86,13 @@ void runQuickhullPar(std::vector<point<T>>& pts) {
 	point<T> rightmostPt = pts[rightmost];
 	std::swap(pts.back(), pts[rightmost]);
 	
+	phase.switchTo("partition");
 	auto belowPointsEndIt = std::partition(pts.begin() + 1, pts.end() - 1, [&] (const point<T>& p) -> bool {
 		return p.sideOfLine(leftmostPt, rightmostPt) == side::right;
 	});
 	
 	std::swap(pts.back(), *belowPointsEndIt);
+	phase.stop();
 	
 	ParallelData pdata;
 	
@@ -82,6 +105,7 @@ void runQuickhullPar(std::vector<point<T>>& pts) {
 	
 	quickhullRecPar<S, T>(std::span<point<T>>(&*belowPointsEndIt + 1, pts.data() + pts.size()), leftmostPt, rightmostPt, remParallelDepth - 1, pdata);
 	
+	phase.switchTo("join");
 	while (true) {
 		std::unique_lock<std::mutex> lg(pdata.lock);
 		if (pdata.threads.empty()) break;
@@ -91,6 +115,7 @@ void runQuickhullPar(std::vector<point<T>>& pts) {
 		thread.join();
 	}
 	
+	phase.switchTo("compaction");
 	removeNotOnHull(pts);
 }
 
@@ -0,0 +1,117 @@
+#include "json_writer.hpp"
+
+#include <charconv>
+#include <cmath>
+
+void JsonWriter::newLine() {
+	stream << '\n';
+	for (size_t i = 0; i < hasElements.size(); i++) {
+		stream << '\t';
+	}
+}
+
+// Writes the comma and line break before a value, unless it directly follows its key
+void JsonWriter::beginValue() {
+	if (afterKey) {
+		afterKey = false;
+		return;
+	}
+	if (!hasElements.empty()) {
+		if (hasElements.back())
+			stream << ',';
+		hasElements.back() = true;
+		newLine();
+	}
+}
+
+void JsonWriter::beginObject() {
+	beginValue();
+	stream << '{';
+	hasElements.push_back(false);
+}
+
+void JsonWriter::endObject() {
+	bool hadElements = hasElements.back();
+	hasElements.pop_back();
+	if (hadElements)
+		newLine();
+	stream << '}';
+	if (hasElements.empty())
+		stream << '\n';
+}
+
+void JsonWriter::beginArray() {
+	beginValue();
+	stream << '[';
+	hasElements.push_back(false);
+}
+
+void JsonWriter::endArray() {
+	bool hadElements = hasElements.back();
+	hasElements.pop_back();
+	if (hadElements)
+		newLine();
+	stream << ']';
+}
+
+void JsonWriter::key(std::string_view name) {
+	beginValue();
+	writeString(name);
+	stream << ": ";
+	afterKey = true;
+}
+
+void JsonWriter::writeString(std::string_view string) {
+	constexpr char HEX_DIGITS[] = "0123456789abcdef";
+	stream << '"';
+	for (char c : string) {
+		switch (c) {
+		case '"': stream << "\\\""; break;
+		case '\\': stream << "\\\\"; break;
+		case '\n': stream << "\\n"; break;
+		case '\t': stream << "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				stream << "\\u00" << HEX_DIGITS[c >> 4] << HEX_DIGITS[c & 15];
+			} else {
+				stream << c;
+			}
+		}
+	}
+	stream << '"';
+}
+
+void JsonWriter::value(std::string_view string) {
+	beginValue();
+	writeString(string);
+}
+
+void JsonWriter::value(double number) {
+	beginValue();
+	if (!std::isfinite(number)) {
+		stream << "null";
+		return;
+	}
+	char buffer[32];
+	stream << std::string_view(buffer, std::to_chars(buffer, buffer + sizeof(buffer), number).ptr);
+}
+
+void JsonWriter::value(uint64_t number) {
+	beginValue();
+	stream << number;
+}
+
+void JsonWriter::value(int64_t number) {
+	beginValue();
+	stream << number;
+}
+
+void JsonWriter::value(bool b) {
+	beginValue();
+	stream << (b ? "true" : "false");
+}
+
+void JsonWriter::null() {
+	beginValue();
+	stream << "null";
+}
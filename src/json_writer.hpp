@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// Streams JSON with one member or element per line, keeping track of where commas are needed.
+// Keys and values are written with key() and value(), or together with field().
+struct JsonWriter {
+	std::ostream& stream;
+	std::vector<bool> hasElements; // one entry per open object or array
+	bool afterKey = false;
+	
+	explicit JsonWriter(std::ostream& outputStream) : stream(outputStream) { }
+	
+	void beginObject();
+	void endObject();
+	void beginArray();
+	void endArray();
+	
+	void key(std::string_view name);
+	
+	void value(std::string_view string);
+	void value(const char* string) { value(std::string_view(string)); }
+	void value(double number); // non finite numbers are written as null
+	void value(uint64_t number);
+	void value(int64_t number);
+	void value(bool b);
+	void null();
+	
+	template <typename T>
+	void field(std::string_view name, T v) {
+		key(name);
+		value(v);
+	}
+	
+	void beginValue();
+	void newLine();
+	void writeString(std::string_view string);
+};
@@ -1,7 +1,14 @@
 #include "hull_impl.hpp"
 #include "slice_parallel.hpp"
 #include "pcm.hpp"
+#include "perf_event.hpp"
 #include "perf_data.hpp"
+#include "point_input.hpp"
+#include "point_output.hpp"
+#include "streaming.hpp"
+#include "server.hpp"
+#include "json_writer.hpp"
+#include "cache_state.hpp"
 
 #include <iostream>
 #include <algorithm>
@@ -9,116 +16,382 @@
 #include <chrono>
 #include <cassert>
 #include <charconv>
-#include <iomanip>
 #include <cmath>
 #include <memory>
 #include <span>
 #include <optional>
+#include <fstream>
+#include <thread>
 
-static bool readBinary;
-static bool outputPoints;
+struct OutputOptions {
+	bool outputPoints = true;
+	OutputFormat format = OutputFormat::Text;
+};
 
+// With -r and -w the input is read once and solved numWarmups + numRuns times, from a pristine copy each time.
+// With -cache the input is flushed from or loaded into the cache before each of these runs.
+struct RunOptions {
+	size_t numRuns = 1;
+	size_t numWarmups = 0;
+	CacheState cacheState = CacheState::Unchanged;
+};
+
+struct RecordStats {
+	uint64_t numPoints = 0;
+	size_t numHullPoints = 0;
+	double readTimeMs = 0;
+	double computeTimeMs = 0; // the median of the measured runs when repeated
+	double outputTimeMs = 0;
+	double elapsedTimeMs = 0; // read + compute
+	size_t numWarmups = 0;
+	std::vector<double> runTimesMs; // compute time of every measured run
+};
+
+// Kept between records so that batch runs reuse their allocations
 template <typename T>
-void readRunAndOutput(uint64_t numPoints, std::function<void(std::vector<point<T>>&)> run) {
-	auto beforeTime = std::chrono::high_resolution_clock::now();
-	
-	std::vector<pointd> pointsd(numPoints);
-	if (readBinary) {
-		std::cin.read(reinterpret_cast<char*>(pointsd.data()), pointsd.size() * sizeof(point<T>));
-	} else {
-		for (uint64_t i = 0; i < numPoints; i++) {
-			std::string line;
-			std::getline(std::cin, line);
-			size_t spacePos = line.find(' ');
-			assert(spacePos != std::string::npos);
-			
-			std::from_chars(&line[0], &line[spacePos], pointsd[i].x);
-			std::from_chars(&line[spacePos + 1], &line[line.size()], pointsd[i].y);
-		}
-	}
-	
-	std::vector<point<T>>* points;
-	std::vector<point<T>> pointsTVec;
-	if constexpr (std::is_same_v<T, double>) {
-		points = &pointsd;
-	} else {
-		points = &pointsTVec;
-		pointsTVec.resize(pointsd.size());
-		for (uint64_t i = 0; i < numPoints; i++) {
-			if constexpr (std::is_integral_v<T>) {
-				pointsd[i].x = std::round(pointsd[i].x);
-				pointsd[i].y = std::round(pointsd[i].y);
-			}
-			pointsTVec[i] = point<T>(pointsd[i]);
-		}
+struct SolveBuffers {
+	std::vector<point<T>> points;
+	SOABuffer<T> soa;
+	// The input as read, restored before each repeated run
+	std::vector<point<T>> pristinePoints;
+	SOABuffer<T> pristineSoa;
+};
+
+static double msBetween(std::chrono::high_resolution_clock::time_point a, std::chrono::high_resolution_clock::time_point b) {
+	return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Runs solve numWarmups + numRuns times between perfData.begin and end, restoring the input before every run
+// but the first, and records the compute times of the measured runs. PerfData keeps what it measured in the last run.
+// prepareCache puts the input in the requested cache state, after restoring since that brings it into cache.
+static void runRepeated(PerfData& perfData, const RunOptions& runOptions, RecordStats& stats,
+                        const std::function<void()>& restore, const std::function<void()>& prepareCache,
+                        const std::function<void()>& solve) {
+	stats.numWarmups = runOptions.numWarmups;
+	for (size_t i = 0; i < runOptions.numWarmups + runOptions.numRuns; i++) {
+		if (i != 0)
+			restore();
+		if (runOptions.cacheState != CacheState::Unchanged)
+			prepareCache();
+		perfData.begin();
+		solve();
+		perfData.end();
+		if (i >= runOptions.numWarmups)
+			stats.runTimesMs.push_back(msBetween(perfData.startTime, perfData.endTime));
 	}
+}
+
+static double medianOf(std::vector<double> values) {
+	std::sort(values.begin(), values.end());
+	size_t mid = values.size() / 2;
+	return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+// readAndRun reads the input, runs the implementation and stores the resulting hull in buffers.points
+template <typename T>
+RecordStats readRunAndOutput(PointInput& input, PerfData& perfData, SolveBuffers<T>& buffers, const OutputOptions& output,
+                             std::function<void(RecordStats&)> readAndRun) {
+	RecordStats stats;
+	stats.numPoints = input.numPoints;
 	
-	run(*points);
+	auto beforeTime = std::chrono::high_resolution_clock::now();
+	readAndRun(stats);
 	auto endTime = std::chrono::high_resolution_clock::now();
+	if (input.truncated)
+		std::exit(1);
 	
-	std::cout << "on hull: " << points->size() << "\n";
-	if (outputPoints) {
-		std::rotate(points->begin(), std::min_element(points->begin(), points->end()), points->end());
-		std::cout << std::setprecision(15) << std::fixed;
-		for (const auto& point : *points) {
-			if (std::isnan(point.x) || std::isnan(point.y) || std::isinf(point.x) || std::isinf(point.y)) {
-				std::cerr << "output contains inf/nan!\n";
-			}
-			std::cout << point.x << " " << point.y << "\n";
-		}
+	std::vector<point<T>>& points = buffers.points;
+	if (output.outputPoints) {
+		writeHull<T>(std::cout, points, output.format);
+		std::cout.flush();
+	} else {
+		std::cout << "on hull: " << points.size() << "\n";
 	}
+	auto outputEndTime = std::chrono::high_resolution_clock::now();
 	
-	std::cerr << "elapsed time: " << std::chrono::duration<double, std::milli>(endTime - beforeTime).count() << " ms\n";
+	stats.numHullPoints = points.size();
+	stats.computeTimeMs = stats.runTimesMs.size() > 1 ? medianOf(stats.runTimesMs) : msBetween(perfData.startTime, perfData.endTime);
+	stats.outputTimeMs = msBetween(endTime, outputEndTime);
+	stats.elapsedTimeMs = msBetween(beforeTime, endTime);
+	return stats;
 }
 
 template <typename T>
-void readRunAndOutputSOA(size_t numPoints, PerfData& perfData, HullSolveFunctionSOA<T> run, size_t soaAlignment) {
-	readRunAndOutput<T>(numPoints, [&] (std::vector<point<T>>& points) {
-		size_t alignment = std::max<size_t>(soaAlignment, alignof(std::max_align_t));
-		size_t numPointsRoundedUp = (points.size() + alignment) & ~(alignment - 1);
-		size_t pointsBytes = numPointsRoundedUp * sizeof(T);
-		char* pointsMemory = static_cast<char*>(std::aligned_alloc(alignment, pointsBytes * 2));
-		T* pointsSoaX = reinterpret_cast<T*>(pointsMemory);
-		T* pointsSoaY = reinterpret_cast<T*>(pointsMemory + pointsBytes);
+RecordStats readRunAndOutputSOA(PointInput& input, PerfData& perfData, SolveBuffers<T>& buffers, const OutputOptions& output, HullSolveFunctionSOA<T> run, size_t soaAlignment,
+                                const RunOptions& runOptions) {
+	return readRunAndOutput<T>(input, perfData, buffers, output, [&] (RecordStats& stats) {
+		auto beforeReadTime = std::chrono::high_resolution_clock::now();
+		SOABuffer<T>& soa = buffers.soa;
+		soa.resize(input.numPoints, soaAlignment);
+		if (!input.readPointsSOA<T>({ soa.x, soa.numPoints }, { soa.y, soa.numPoints }))
+			return;
+		stats.readTimeMs = msBetween(beforeReadTime, std::chrono::high_resolution_clock::now());
 		
-		for (size_t i = 0; i < points.size(); i++) {
-			pointsSoaX[i] = points[i].x;
-			pointsSoaY[i] = points[i].y;
-		}
-		for (size_t i = points.size(); i < numPointsRoundedUp; i++) {
-			pointsSoaX[i] = point<T>::notOnHull.x;
-			pointsSoaY[i] = point<T>::notOnHull.y;
+		// Implementations may also write the padding, which is restored with the points
+		size_t paddedSize = SOABuffer<T>::paddedSize(soa.numPoints, soaAlignment);
+		SOABuffer<T>& pristine = buffers.pristineSoa;
+		if (runOptions.numWarmups + runOptions.numRuns > 1) {
+			pristine.resize(soa.numPoints, soaAlignment);
+			std::copy_n(soa.x, paddedSize, pristine.x);
+			std::copy_n(soa.y, paddedSize, pristine.y);
 		}
 		
-		perfData.begin();
-		size_t numHullPoints = run(SOAPoints<T> {
-			.x = { pointsSoaX, points.size() },
-			.y = { pointsSoaY, points.size() }
+		size_t numHullPoints = 0;
+		runRepeated(perfData, runOptions, stats, [&] {
+			std::copy_n(pristine.x, paddedSize, soa.x);
+			std::copy_n(pristine.y, paddedSize, soa.y);
+		}, [&] {
+			prepareCacheState(runOptions.cacheState, soa.x, paddedSize * sizeof(T));
+			prepareCacheState(runOptions.cacheState, soa.y, paddedSize * sizeof(T));
+		}, [&] {
+			numHullPoints = run(soa.points());
 		});
-		perfData.end();
 		
-		points.clear();
+		buffers.points.resize(numHullPoints);
 		for (size_t i = 0; i < numHullPoints; i++) {
-			points.emplace_back(pointsSoaX[i], pointsSoaY[i]);
+			buffers.points[i] = point<T>(soa.x[i], soa.y[i]);
 		}
+	});
+}
+
+template <typename T>
+RecordStats readRunAndOutputAOS(PointInput& input, PerfData& perfData, SolveBuffers<T>& buffers, const OutputOptions& output, HullSolveFunction<T> run,
+                                const RunOptions& runOptions) {
+	return readRunAndOutput<T>(input, perfData, buffers, output, [&] (RecordStats& stats) {
+		auto beforeReadTime = std::chrono::high_resolution_clock::now();
+		buffers.points.resize(input.numPoints);
+		if (!input.readPoints<T>(buffers.points))
+			return;
+		stats.readTimeMs = msBetween(beforeReadTime, std::chrono::high_resolution_clock::now());
+		
+		if (runOptions.numWarmups + runOptions.numRuns > 1)
+			buffers.pristinePoints.assign(buffers.points.begin(), buffers.points.end());
+		runRepeated(perfData, runOptions, stats, [&] {
+			buffers.points.assign(buffers.pristinePoints.begin(), buffers.pristinePoints.end());
+		}, [&] {
+			prepareCacheState(runOptions.cacheState, buffers.points.data(), buffers.points.size() * sizeof(point<T>));
+		}, [&] {
+			run(buffers.points);
+		});
+	});
+}
+
+template <typename T>
+RecordStats readRunAndOutputStreaming(PointInput& input, PerfData& perfData, SolveBuffers<T>& buffers, const OutputOptions& output, HullSolveFunction<T> run, size_t chunkSize) {
+	return readRunAndOutput<T>(input, perfData, buffers, output, [&] (RecordStats& recordStats) {
+		StreamingStats stats;
+		perfData.begin();
+		solveStreaming<T>(input, run, chunkSize, buffers.points, stats);
+		perfData.end();
 		
-		std::free(pointsMemory);
+		recordStats.readTimeMs = stats.readTimeMs;
+		std::cerr << "chunks: " << stats.numChunks << "\n";
+		std::cerr << "chunk compute time: " << stats.computeTimeMs << " ms\n";
 	});
 }
 
 template <typename T>
-void readRunAndOutputAOS(size_t numPoints, PerfData& perfData, HullSolveFunction<T> run, std::optional<SolveSliceParallelArgs> solveSliceParallelArgs) {
-	if (solveSliceParallelArgs) {
+RecordStats readRunAndOutputPipelined(PointInput& input, PerfData& perfData, SolveBuffers<T>& buffers, const OutputOptions& output, HullSolveFunction<T> run, size_t chunkSize, size_t numWorkers) {
+	return readRunAndOutput<T>(input, perfData, buffers, output, [&] (RecordStats& recordStats) {
+		PipelineStats stats;
+		perfData.begin();
+		solvePipelined<T>(input, run, chunkSize, numWorkers, buffers.points, stats);
+		perfData.end();
+		
+		recordStats.readTimeMs = stats.readTimeMs;
+		std::cerr << "pipeline stages (" << stats.numChunks << " chunks, " << numWorkers << " workers):\n";
+		std::cerr << "| read: " << stats.readTimeMs << " ms\n";
+		std::cerr << "| read stalled: " << stats.readStallTimeMs << " ms\n";
+		std::cerr << "| chunk compute: " << stats.computeTimeMs << " ms\n";
+		std::cerr << "| compute stalled: " << stats.computeStallTimeMs << " ms\n";
+		std::cerr << "| merge: " << stats.mergeTimeMs << " ms\n";
+	});
+}
+
+// The run times of repeated runs are kept for a single record only, they do not add up over records
+static RecordStats sumRecordStats(const std::vector<RecordStats>& records) {
+	if (records.size() == 1)
+		return records.front();
+	RecordStats total;
+	for (const RecordStats& stats : records) {
+		total.numPoints += stats.numPoints;
+		total.numHullPoints += stats.numHullPoints;
+		total.readTimeMs += stats.readTimeMs;
+		total.computeTimeMs += stats.computeTimeMs;
+		total.outputTimeMs += stats.outputTimeMs;
+		total.elapsedTimeMs += stats.elapsedTimeMs;
+	}
+	return total;
+}
+
+void printRecordStats(const PointInput& input, const RecordStats& stats) {
+	std::cerr << "read time: " << stats.readTimeMs << " ms" << (input.isMapped() ? " (mmap)" : "") << "\n";
+	if (stats.runTimesMs.size() > 1) {
+		const std::vector<double>& times = stats.runTimesMs;
+		double mean = 0;
+		for (double time : times) {
+			mean += time / static_cast<double>(times.size());
+		}
+		double variance = 0;
+		for (double time : times) {
+			variance += (time - mean) * (time - mean) / static_cast<double>(times.size() - 1);
+		}
+		std::cerr << "runs: " << times.size() << " after " << stats.numWarmups << " warmup runs, the measurements below are of the last run\n";
+		std::cerr << "| run times:";
+		for (double time : times) {
+			std::cerr << " " << time;
+		}
+		std::cerr << " ms\n";
+		std::cerr << "| median: " << medianOf(times) << " ms, min: " << *std::min_element(times.begin(), times.end())
+		          << " ms, mean: " << mean << " ms, stddev: " << std::sqrt(variance) << " ms\n";
+	}
+	std::cerr << "output time: " << stats.outputTimeMs << " ms\n";
+	std::cerr << "elapsed time: " << stats.elapsedTimeMs << " ms\n";
+}
+
+// In batch mode the input holds several point sets, each with its own header, which are solved one after
+// another reusing the same buffers. Every record gets a summary line and the totals are printed at the end.
+template <typename T>
+std::vector<RecordStats> selectModeAndRun(
+	PointInput& input, PerfData& perfData, const OutputOptions& output,
+	HullSolveFunction<T> run, HullSolveFunctionSOA<T> runSoa, size_t soaAlignment,
+	std::optional<SolveSliceParallelArgs> solveSliceParallelArgs, size_t streamChunkSize,
+	size_t pipelineChunkSize, size_t pipelineWorkers, bool batch, const RunOptions& runOptions
+) {
+	if (solveSliceParallelArgs && run) {
 		run = [innerSolve=run, solveSliceParallelArgs] (std::vector<point<T>>& p) {
 			solveSliceParallel<T>(p, innerSolve, *solveSliceParallelArgs);
 		};
 	}
 	
-	readRunAndOutput<T>(numPoints, [&] (std::vector<point<T>>& points) {
-		perfData.begin();
-		run(points);
-		perfData.end();
-	});
+	if (runSoa && (streamChunkSize || pipelineChunkSize)) {
+		run = soaSolveAsAos<T>(runSoa, soaAlignment);
+	}
+	
+	SolveBuffers<T> buffers;
+	auto runRecord = [&] () {
+		if (pipelineChunkSize) {
+			return readRunAndOutputPipelined<T>(input, perfData, buffers, output, run, pipelineChunkSize, pipelineWorkers);
+		} else if (streamChunkSize) {
+			return readRunAndOutputStreaming<T>(input, perfData, buffers, output, run, streamChunkSize);
+		} else if (runSoa) {
+			return readRunAndOutputSOA<T>(input, perfData, buffers, output, runSoa, soaAlignment, runOptions);
+		} else {
+			return readRunAndOutputAOS<T>(input, perfData, buffers, output, run, runOptions);
+		}
+	};
+	
+	if (!batch) {
+		RecordStats stats = runRecord();
+		printRecordStats(input, stats);
+		perfData.printStatistics();
+		return { stats };
+	}
+	
+	std::vector<RecordStats> records;
+	do {
+		RecordStats stats = runRecord();
+		std::cerr << "record " << records.size() << ": " << stats.numPoints << " points, on hull: " << stats.numHullPoints
+		          << ", read time: " << stats.readTimeMs << " ms, compute time: " << stats.computeTimeMs << " ms\n";
+		records.push_back(stats);
+	} while (input.nextRecord());
+	
+	RecordStats total = sumRecordStats(records);
+	std::cerr << "records: " << records.size() << " (" << total.numPoints << " points)\n";
+	printRecordStats(input, total);
+	std::cerr << "compute time: " << total.computeTimeMs << " ms\n";
+	return records;
+}
+
+// What was run, for the JSON report
+struct RunDescription {
+	std::string_view implName;
+	std::string_view implArgs;
+	bool useIntVersion = false;
+	std::string_view mode;
+	size_t numReadThreads = 0;
+	size_t sliceParallelThreads = 0;
+	size_t pipelineWorkers = 0;
+	CacheState cacheState = CacheState::Unchanged;
+};
+
+static void writeRecordStatsJson(JsonWriter& json, const RecordStats& stats) {
+	json.field("points", stats.numPoints);
+	json.field("hull_points", static_cast<uint64_t>(stats.numHullPoints));
+	json.field("read_time_ms", stats.readTimeMs);
+	json.field("compute_time_ms", stats.computeTimeMs);
+	json.field("output_time_ms", stats.outputTimeMs);
+	json.field("elapsed_time_ms", stats.elapsedTimeMs);
+	json.field("warmup_runs", static_cast<uint64_t>(stats.numWarmups));
+	json.key("run_times_ms");
+	json.beginArray();
+	for (double time : stats.runTimesMs) {
+		json.value(time);
+	}
+	json.endArray();
+}
+
+// Writes the timeline of the last solve, for chrome://tracing or Perfetto
+static bool writeTraceFile(const char* path, PerfData& perfData) {
+	std::ofstream file(path);
+	if (!file) {
+		std::cerr << "failed to open " << path << " for the trace\n";
+		return false;
+	}
+	JsonWriter json(file);
+	perfData.writeTrace(json);
+	return static_cast<bool>(file);
+}
+
+// Writes a machine readable summary of the run. "measurements" holds what PerfData measured around the
+// last solve, which in batch mode is the last record, the per record numbers are in "records".
+static bool writeJsonReport(const char* path, const RunDescription& run, const PointInput& input,
+                            const std::vector<RecordStats>& records, PerfData& perfData) {
+	std::ofstream file(path);
+	if (!file) {
+		std::cerr << "failed to open " << path << " for the json report\n";
+		return false;
+	}
+	
+	static constexpr std::string_view INPUT_FORMAT_NAMES[] = { "text", "binary", "binary_int" };
+	
+	JsonWriter json(file);
+	json.beginObject();
+	json.field("implementation", run.implName);
+	json.field("args", run.implArgs);
+	json.field("coordinates", run.useIntVersion ? "int64" : "double");
+	json.field("mode", run.mode);
+	json.field("input_format", INPUT_FORMAT_NAMES[static_cast<size_t>(input.format)]);
+	json.field("mmap", input.isMapped());
+	json.field("cache_state", cacheStateName(run.cacheState));
+	
+	json.key("threads");
+	json.beginObject();
+	json.field("hardware", static_cast<uint64_t>(std::thread::hardware_concurrency()));
+	json.field("read", static_cast<uint64_t>(run.numReadThreads ? run.numReadThreads : std::thread::hardware_concurrency()));
+	json.field("slice_parallel", static_cast<uint64_t>(run.sliceParallelThreads));
+	json.field("pipeline_workers", static_cast<uint64_t>(run.pipelineWorkers));
+	json.endObject();
+	
+	writeRecordStatsJson(json, sumRecordStats(records));
+	
+	json.key("measurements");
+	json.beginObject();
+	perfData.writeJson(json);
+	json.endObject();
+	
+	if (records.size() > 1) {
+		json.key("records");
+		json.beginArray();
+		for (const RecordStats& stats : records) {
+			json.beginObject();
+			writeRecordStatsJson(json, stats);
+			json.endObject();
+		}
+		json.endArray();
+	}
+	json.endObject();
+	return static_cast<bool>(file);
 }
 
 [[noreturn]] void printImplementationNamesAndExit() {
@@ -138,6 +411,18 @@ void readRunAndOutputAOS(size_t numPoints, PerfData& perfData, HullSolveFunction
 	std::exit(1);
 }
 
+// Parses the value of a -name=value argument into value, false with a message if it is not a number of at least min
+static bool parseSizeArg(std::string_view arg, size_t min, size_t& value) {
+	size_t eqPos = arg.find('=');
+	std::string_view text = arg.substr(eqPos + 1);
+	auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+	if (result.ec != std::errc() || result.ptr != text.data() + text.size() || value < min) {
+		std::cerr << "invalid value for " << arg.substr(0, eqPos) << ": " << text << ", expected a number of at least " << min << "\n";
+		return false;
+	}
+	return true;
+}
+
 int main(int argv, char** argc) {
 	std::ios_base::sync_with_stdio(false);
 	std::cin.tie(nullptr);
@@ -147,8 +432,22 @@ int main(int argv, char** argc) {
 	
 	bool useIntVersion = false;
 	bool usePcm = false;
-	outputPoints = true;
+	bool usePerfEvents = false;
+	bool collectThreadPhases = false;
+	bool trackAllocations = false;
+	OutputOptions output;
 	std::string_view implName;
+	const char* inputPath = nullptr;
+	const char* jsonReportPath = nullptr;
+	const char* tracePath = nullptr;
+	size_t numReadThreads = 0;
+	size_t streamChunkSize = 0;
+	size_t pipelineChunkSize = 0;
+	size_t pipelineWorkers = 1;
+	bool batch = false;
+	RunOptions runOptions;
+	bool server = false;
+	const char* serverSocketPath = nullptr;
 	std::optional<SolveSliceParallelArgs> solveSliceParallelArgs;
 	for (int i = 1; i < argv; i++) {
 		std::string_view arg = argc[i];
@@ -156,8 +455,53 @@ int main(int argv, char** argc) {
 			useIntVersion = true;
 		} else if (arg == "-pcm") {
 			usePcm = true;
+		} else if (arg == "-perf") {
+			usePerfEvents = true;
+		} else if (arg == "-phases") {
+			collectThreadPhases = true;
+		} else if (arg == "-alloc") {
+			trackAllocations = true;
 		} else if (arg == "-q") {
-			outputPoints = false;
+			output.outputPoints = false;
+		} else if (arg == "-ob") {
+			output.format = OutputFormat::Binary;
+		} else if (arg == "-server") {
+			server = true;
+		} else if (arg.starts_with("-server=")) {
+			server = true;
+			serverSocketPath = argc[i] + 8;
+		} else if (arg == "-batch") {
+			batch = true;
+		} else if (arg.starts_with("-json=")) {
+			jsonReportPath = argc[i] + 6;
+		} else if (arg.starts_with("-trace=")) {
+			tracePath = argc[i] + 7;
+		} else if (arg.starts_with("-in=")) {
+			inputPath = argc[i] + 4;
+		} else if (arg.starts_with("-stream=")) {
+			// Every chunk is solved on its own, smaller ones are too small for the implementations
+			if (!parseSizeArg(arg, MIN_HULL_POINTS, streamChunkSize))
+				return 1;
+		} else if (arg.starts_with("-pipeline=")) {
+			if (!parseSizeArg(arg, MIN_HULL_POINTS, pipelineChunkSize))
+				return 1;
+		} else if (arg.starts_with("-pipelineWorkers=")) {
+			if (!parseSizeArg(arg, 1, pipelineWorkers))
+				return 1;
+		} else if (arg.starts_with("-r=")) {
+			std::from_chars(arg.data() + 3, arg.data() + arg.size(), runOptions.numRuns);
+			runOptions.numRuns = std::max<size_t>(runOptions.numRuns, 1);
+		} else if (arg.starts_with("-w=")) {
+			std::from_chars(arg.data() + 3, arg.data() + arg.size(), runOptions.numWarmups);
+		} else if (arg.starts_with("-cache=")) {
+			std::optional<CacheState> cacheState = cacheStateFromString(arg.substr(7));
+			if (!cacheState) {
+				std::cerr << "unknown cache state " << arg.substr(7) << ", expected cold, warm or unchanged\n";
+				return 1;
+			}
+			runOptions.cacheState = *cacheState;
+		} else if (arg.starts_with("-rt")) {
+			std::from_chars(arg.data() + 3, arg.data() + arg.size(), numReadThreads);
 		} else if (arg.starts_with("-sp")) {
 			std::string_view numThreads = arg.substr(3);
 			solveSliceParallelArgs = SolveSliceParallelArgs();
@@ -171,16 +515,30 @@ int main(int argv, char** argc) {
 		}
 	}
 	
+	if (server) {
+		return runServer(serverSocketPath, numReadThreads);
+	}
+	
+	if ((runOptions.numRuns > 1 || runOptions.numWarmups != 0 || runOptions.cacheState != CacheState::Unchanged) && (streamChunkSize || pipelineChunkSize)) {
+		std::cerr << "-r, -w and -cache are ignored with -stream and -pipeline, which solve while reading\n";
+		runOptions = RunOptions();
+	}
+	
 	if (implName.empty()) {
 		std::cout << "No implementation specified.";
 		printImplementationNamesAndExit();
 	}
 	
+	HullContext context;
 	size_t implNameColonPos = implName.find(':');
 	if (implNameColonPos != std::string_view::npos) {
-		implArgs = implName.substr(implNameColonPos + 1);
+		context.args = implName.substr(implNameColonPos + 1);
 		implName = implName.substr(0, implNameColonPos);
 	}
+	context.threadPhases.enabled = collectThreadPhases || tracePath != nullptr;
+	context.threadPhases.recordSpans = tracePath != nullptr;
+	context.threadPhases.useCounters = collectThreadPhases && usePerfEvents;
+	HullContextScope contextScope(context);
 	
 	auto implIterator = std::find_if(
 		hullImplementations->begin(), hullImplementations->end(),
@@ -194,43 +552,59 @@ int main(int argv, char** argc) {
 		return 1;
 	}
 	
-	uint64_t numPoints = 0;
-	
-	char c0 = std::cin.get();
-	if (c0 == 'B') {
-		readBinary = true;
-		std::cin.read(reinterpret_cast<char*>(&numPoints), sizeof(numPoints));
-	} else if (c0 == '2') {
-		std::string line;
-		std::getline(std::cin, line);
-		std::getline(std::cin, line);
-		numPoints = std::stoi(line);
-	} else {
-		std::cerr << "unexpected first character " << c0 << ", expected 2 or B\n";
+	PointInput input;
+	input.numReadThreads = numReadThreads;
+	if (!input.open(inputPath))
 		return 1;
-	}
-	
-	std::cin.precision(15);
 	
 	std::unique_ptr<PerfData> perfData;
 	if (usePcm)
 		perfData = createPCMPerfData();
+	if (usePerfEvents && perfData == nullptr)
+		perfData = createPerfEventPerfData();
 	if (perfData == nullptr)
 		perfData = std::make_unique<PerfData>();
+	if (trackAllocations && !allocationTrackingAvailable())
+		std::cerr << "allocation tracking is not available in this build\n";
+	perfData->trackAllocations = trackAllocations && allocationTrackingAvailable();
+	
+	if (runOptions.cacheState != CacheState::Unchanged)
+		std::cerr << "cache state before each run: " << cacheStateName(runOptions.cacheState) << "\n";
 	
+	std::vector<RecordStats> records;
 	if (useIntVersion) {
-		if (implIterator->runIntSoa) {
-			readRunAndOutputSOA<int64_t>(numPoints, *perfData, implIterator->runIntSoa, implIterator->soaAlignment);
-		} else {
-			readRunAndOutputAOS<int64_t>(numPoints, *perfData, implIterator->runInt, solveSliceParallelArgs);
-		}
+		records = selectModeAndRun<int64_t>(input, *perfData, output, implIterator->runInt, implIterator->runIntSoa,
+		                                    implIterator->soaAlignment, solveSliceParallelArgs, streamChunkSize,
+		                                    pipelineChunkSize, pipelineWorkers, batch, runOptions);
 	} else {
-		if (implIterator->runDoubleSoa) {
-			readRunAndOutputSOA<double>(numPoints, *perfData, implIterator->runDoubleSoa, implIterator->soaAlignment);
-		} else {
-			readRunAndOutputAOS<double>(numPoints, *perfData, implIterator->runDouble, solveSliceParallelArgs);
+		records = selectModeAndRun<double>(input, *perfData, output, implIterator->runDouble, implIterator->runDoubleSoa,
+		                                   implIterator->soaAlignment, solveSliceParallelArgs, streamChunkSize,
+		                                   pipelineChunkSize, pipelineWorkers, batch, runOptions);
+	}
+	
+	if (jsonReportPath != nullptr) {
+		bool hasSoa = useIntVersion ? static_cast<bool>(implIterator->runIntSoa) : static_cast<bool>(implIterator->runDoubleSoa);
+		bool hasAos = useIntVersion ? static_cast<bool>(implIterator->runInt) : static_cast<bool>(implIterator->runDouble);
+		bool usesSliceParallel = solveSliceParallelArgs && hasAos && (!hasSoa || streamChunkSize || pipelineChunkSize);
+		size_t sliceParallelThreads = 0;
+		if (usesSliceParallel) {
+			sliceParallelThreads = solveSliceParallelArgs->numThreads ? solveSliceParallelArgs->numThreads : std::thread::hardware_concurrency();
+			sliceParallelThreads = std::max<size_t>(sliceParallelThreads, 2);
 		}
+		RunDescription run {
+			.implName = implName,
+			.implArgs = context.args,
+			.useIntVersion = useIntVersion,
+			.mode = pipelineChunkSize ? "pipeline" : streamChunkSize ? "stream" : hasSoa ? "soa" : "aos",
+			.numReadThreads = numReadThreads,
+			.sliceParallelThreads = sliceParallelThreads,
+			.pipelineWorkers = pipelineChunkSize ? pipelineWorkers : 0,
+			.cacheState = runOptions.cacheState
+		};
+		if (!writeJsonReport(jsonReportPath, run, input, records, *perfData))
+			return 1;
 	}
 	
-	perfData->printStatistics();
+	if (tracePath != nullptr && !writeTraceFile(tracePath, *perfData))
+		return 1;
 }
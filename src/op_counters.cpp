@@ -0,0 +1,41 @@
+#include "op_counters.hpp"
+
+#ifdef OP_COUNTERS
+thread_local OpCounts threadOpCounts;
+#endif
+
+const char* opCounterName(OpCounter counter) {
+	switch (counter) {
+	case OpCounter::OrientationTests: return "orientation_tests";
+	case OpCounter::PartitionMoves: return "partition_moves";
+	case OpCounter::RecursionCalls: return "recursion_calls";
+	case OpCounter::TangentSteps: return "tangent_steps";
+	case OpCounter::FailedHullGuesses: return "failed_hull_guesses";
+	case OpCounter::Count: break;
+	}
+	return "unknown";
+}
+
+void OpCounts::add(const OpCounts& other) {
+	for (size_t i = 0; i < numOpCounters; i++) {
+		values[i] += other.values[i];
+	}
+	depthSum += other.depthSum;
+	maxDepth = std::max(maxDepth, other.maxDepth);
+	for (size_t i = 0; i < maxCountedLevels; i++) {
+		discardedPerLevel[i] += other.discardedPerLevel[i];
+	}
+}
+
+double OpCounts::averageDepth() const {
+	uint64_t numCalls = get(OpCounter::RecursionCalls);
+	return numCalls == 0 ? 0.0 : static_cast<double>(depthSum) / static_cast<double>(numCalls);
+}
+
+size_t OpCounts::numLevels() const {
+	size_t numLevels = maxCountedLevels;
+	while (numLevels > 0 && discardedPerLevel[numLevels - 1] == 0) {
+		numLevels--;
+	}
+	return numLevels;
+}
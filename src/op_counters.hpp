@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Counters of the work the implementations do, to explain why one is slow on a dataset rather than
+// only that it is. Compiled in with -DOP_COUNTERS=ON, otherwise the counting functions are empty.
+enum class OpCounter {
+	OrientationTests,
+	PartitionMoves,
+	RecursionCalls,
+	TangentSteps,
+	FailedHullGuesses,
+	Count
+};
+
+constexpr size_t numOpCounters = static_cast<size_t>(OpCounter::Count);
+constexpr size_t maxCountedLevels = 64;
+
+const char* opCounterName(OpCounter counter);
+
+struct OpCounts {
+	uint64_t values[numOpCounters];
+	uint64_t depthSum;
+	uint64_t maxDepth;
+	// Points found not to be on the hull at each recursion depth, level 0 being the work done before
+	// recursing. Deeper levels are added to the last one.
+	uint64_t discardedPerLevel[maxCountedLevels];
+	// Recursion depth the counting thread is at, not a total
+	size_t depth;
+	
+	// Adds the totals of other, keeping the larger maximum depth
+	void add(const OpCounts& other);
+	uint64_t get(OpCounter counter) const { return values[static_cast<size_t>(counter)]; }
+	double averageDepth() const;
+	// Levels up to the deepest one that discarded points
+	size_t numLevels() const;
+};
+
+#ifdef OP_COUNTERS
+// Counts of the calling thread, added to its HullContext when its HullContextScope ends
+extern thread_local OpCounts threadOpCounts;
+
+inline void countOp(OpCounter counter, uint64_t n = 1) {
+	threadOpCounts.values[static_cast<size_t>(counter)] += n;
+}
+
+inline void countDiscarded(uint64_t numPoints) {
+	threadOpCounts.discardedPerLevel[std::min(threadOpCounts.depth, maxCountedLevels - 1)] += numPoints;
+}
+
+inline size_t currentRecursionDepth() {
+	return threadOpCounts.depth;
+}
+
+// Continues counting at depth, for recursion that moves on to another thread
+inline void setRecursionDepth(size_t depth) {
+	threadOpCounts.depth = depth;
+}
+
+inline void enterRecursionLevel() {
+	OpCounts& counts = threadOpCounts;
+	counts.depth++;
+	counts.values[static_cast<size_t>(OpCounter::RecursionCalls)]++;
+	counts.depthSum += counts.depth;
+	counts.maxDepth = std::max<uint64_t>(counts.maxDepth, counts.depth);
+}
+
+// One level deeper for the lifetime of the object
+struct RecursionLevel {
+	size_t outerDepth;
+	
+	RecursionLevel() : outerDepth(threadOpCounts.depth) {
+		enterRecursionLevel();
+	}
+	~RecursionLevel() {
+		threadOpCounts.depth = outerDepth;
+	}
+	RecursionLevel(const RecursionLevel&) = delete;
+	RecursionLevel& operator=(const RecursionLevel&) = delete;
+};
+
+// For breadth first implementations processing a whole level at a time: next() goes one level
+// deeper, the depth is restored when the object is destroyed
+struct BreadthFirstLevels {
+	size_t outerDepth;
+	
+	BreadthFirstLevels() : outerDepth(threadOpCounts.depth) { }
+	~BreadthFirstLevels() {
+		threadOpCounts.depth = outerDepth;
+	}
+	BreadthFirstLevels(const BreadthFirstLevels&) = delete;
+	BreadthFirstLevels& operator=(const BreadthFirstLevels&) = delete;
+	
+	void next() {
+		enterRecursionLevel();
+	}
+};
+#else
+inline void countOp(OpCounter, uint64_t = 1) { }
+inline void countDiscarded(uint64_t) { }
+inline size_t currentRecursionDepth() { return 0; }
+inline void setRecursionDepth(size_t) { }
+
+struct RecursionLevel {
+	RecursionLevel() { }
+	RecursionLevel(const RecursionLevel&) = delete;
+	RecursionLevel& operator=(const RecursionLevel&) = delete;
+};
+
+struct BreadthFirstLevels {
+	BreadthFirstLevels() { }
+	BreadthFirstLevels(const BreadthFirstLevels&) = delete;
+	BreadthFirstLevels& operator=(const BreadthFirstLevels&) = delete;
+	
+	void next() { }
+};
+#endif
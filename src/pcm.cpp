@@ -4,6 +4,8 @@
 std::unique_ptr<PerfData> createPCMPerfData() { return nullptr; }
 #else
 
+#include "json_writer.hpp"
+
 #include <cpucounters.h>
 
 struct PCMPerfData : PerfData {
@@ -20,43 +22,70 @@ struct PCMPerfData : PerfData {
 		afterState = pcm::getSystemCounterState();
 	}
 	
+	struct Measurement {
+		std::string_view label;
+		std::string_view jsonName;
+		double value;
+		bool isIntegral;
+	};
+	
+	std::vector<Measurement> getMeasurements() const {
+		std::vector<Measurement> measurements;
+		auto addMeasurment = [&] <typename T> (std::string_view label, std::string_view jsonName, T(*fn)(const pcm::SystemCounterState&, const pcm::SystemCounterState&)) {
+			measurements.push_back({ label, jsonName, static_cast<double>(fn(beforeState, afterState)), std::is_integral_v<T> });
+		};
+		
+		addMeasurment("instr retired", "instructions", &pcm::getInstructionsRetired<pcm::SystemCounterState>);
+		addMeasurment("instr per clock", "ipc", &pcm::getIPC<pcm::SystemCounterState>);
+		addMeasurment("instr per clock (core)", "core_ipc", &pcm::getCoreIPC<pcm::SystemCounterState>);
+		addMeasurment("MC bytes read", "mc_bytes_read", &pcm::getBytesReadFromMC<pcm::SystemCounterState>);
+		addMeasurment("MC bytes written", "mc_bytes_written", &pcm::getBytesWrittenToMC<pcm::SystemCounterState>);
+		addMeasurment("L2 hits", "l2_hits", &pcm::getL2CacheHits<pcm::SystemCounterState>);
+		addMeasurment("L2 misses", "l2_misses", &pcm::getL2CacheMisses<pcm::SystemCounterState>);
+		addMeasurment("L2 hit ratio", "l2_hit_ratio", &pcm::getL2CacheHitRatio<pcm::SystemCounterState>);
+		addMeasurment("L3 hits", "l3_hits", &pcm::getL3CacheHits<pcm::SystemCounterState>);
+		addMeasurment("L3 misses", "l3_misses", &pcm::getL3CacheMisses<pcm::SystemCounterState>);
+		addMeasurment("L3 hit ratio", "l3_hit_ratio", &pcm::getL3CacheHitRatio<pcm::SystemCounterState>);
+		addMeasurment("pl bad speculation", "pipeline_bad_speculation", &pcm::getBadSpeculation<pcm::SystemCounterState>);
+		addMeasurment("pl backend bound", "pipeline_backend_bound", &pcm::getBackendBound<pcm::SystemCounterState>);
+		addMeasurment("pl frontend bound", "pipeline_frontend_bound", &pcm::getFrontendBound<pcm::SystemCounterState>);
+		return measurements;
+	}
+	
 	void printStatistics() override {
 		PerfData::printStatistics();
 		
 		std::cerr << "pcm measurements:\n";
 		
-		std::vector<std::pair<std::string_view, std::string>> measurements;
+		std::vector<Measurement> measurements = getMeasurements();
 		size_t maxLabelLen = 0;
-		auto addMeasurment = [&] <typename T> (std::string_view label, T(*fn)(const pcm::SystemCounterState&, const pcm::SystemCounterState&)) {
-			maxLabelLen = std::max(maxLabelLen, label.size());
-			std::string value = std::to_string(fn(beforeState, afterState));
-			if constexpr (std::is_integral_v<T>) {
+		for (const Measurement& measurement : measurements) {
+			maxLabelLen = std::max(maxLabelLen, measurement.label.size());
+		}
+		
+		for (const Measurement& measurement : measurements) {
+			std::string value;
+			if (measurement.isIntegral) {
+				value = std::to_string(static_cast<uint64_t>(measurement.value));
 				int vlen = value.size();
 				for (int i = 1; i * 3 < vlen; i++) {
 					value.insert(value.begin() + (vlen - i * 3), ',');
 				}
+			} else {
+				value = std::to_string(measurement.value);
 			}
-			measurements.emplace_back(label, std::move(value));
-		};
-		
-		addMeasurment("instr retired", &pcm::getInstructionsRetired<pcm::SystemCounterState>);
-		addMeasurment("instr per clock", &pcm::getIPC<pcm::SystemCounterState>);
-		addMeasurment("instr per clock (core)", &pcm::getCoreIPC<pcm::SystemCounterState>);
-		addMeasurment("MC bytes read", &pcm::getBytesReadFromMC<pcm::SystemCounterState>);
-		addMeasurment("MC bytes written", &pcm::getBytesWrittenToMC<pcm::SystemCounterState>);
-		addMeasurment("L2 hits", &pcm::getL2CacheHits<pcm::SystemCounterState>);
-		addMeasurment("L2 misses", &pcm::getL2CacheMisses<pcm::SystemCounterState>);
-		addMeasurment("L2 hit ratio", &pcm::getL2CacheHitRatio<pcm::SystemCounterState>);
-		addMeasurment("L3 hits", &pcm::getL3CacheHits<pcm::SystemCounterState>);
-		addMeasurment("L3 misses", &pcm::getL3CacheMisses<pcm::SystemCounterState>);
-		addMeasurment("L3 hit ratio", &pcm::getL3CacheHitRatio<pcm::SystemCounterState>);
-		addMeasurment("pl bad speculation", &pcm::getBadSpeculation<pcm::SystemCounterState>);
-		addMeasurment("pl backend bound", &pcm::getBackendBound<pcm::SystemCounterState>);
-		addMeasurment("pl frontend bound", &pcm::getFrontendBound<pcm::SystemCounterState>);
-		
-		for (const auto& [label, value] : measurements) {
-			std::cerr << std::string(maxLabelLen + 2 - label.size(), ' ') << label << ": " << value << "\n";
+			std::cerr << std::string(maxLabelLen + 2 - measurement.label.size(), ' ') << measurement.label << ": " << value << "\n";
+		}
+	}
+	
+	void writeJson(JsonWriter& json) override {
+		PerfData::writeJson(json);
+		json.key("pcm");
+		json.beginObject();
+		for (const Measurement& measurement : getMeasurements()) {
+			json.field(measurement.jsonName, measurement.value);
 		}
+		json.endObject();
 	}
 };
 
@@ -1,18 +1,193 @@
 #include "perf_data.hpp"
+#include "hull_impl.hpp"
+#include "json_writer.hpp"
 
+#include <iomanip>
 #include <iostream>
+#include <string>
+
+void printIntermediateTimes(std::chrono::high_resolution_clock::time_point startTime);
 
 void PerfData::begin() {
+	currentHullContext().clearIntermediateTimes();
+	HullContext& context = currentHullContext();
+	context.collectOpCountsOfThisThread();
+	context.clearOpCounts();
+	ThreadPhases& threadPhases = context.threadPhases;
+	threadPhases.clear();
+	// The thread running the solve comes first
+	if (threadPhases.enabled)
+		threadPhases.recordOfThisThread();
+	if (trackAllocations)
+		beginAllocationTracking();
 	startTime = std::chrono::high_resolution_clock::now();
 }
 
 void PerfData::end() {
 	endTime = std::chrono::high_resolution_clock::now();
+	if (trackAllocations)
+		allocationStats = endAllocationTracking();
+	currentHullContext().collectOpCountsOfThisThread();
 }
 
-void printIntermediateTimes(std::chrono::high_resolution_clock::time_point startTime);
-
 void PerfData::printStatistics() {
 	std::cerr << "compute time: " << std::chrono::duration<double, std::milli>(endTime - startTime).count() << " ms\n";
+	if (allocationStats) {
+		std::cerr << "allocations: " << allocationStats->numAllocations << ", " << allocationStats->bytesAllocated
+		          << " bytes allocated, peak heap: " << allocationStats->peakBytes << " bytes\n";
+	}
 	printIntermediateTimes(startTime);
+	printThreadPhases();
+	printOpCounts();
+}
+
+void PerfData::printThreadPhases() {
+	std::vector<const ThreadPhaseRecord*> records = currentHullContext().threadPhases.getRecords();
+	if (records.empty())
+		return;
+	std::cerr << "thread phases:\n";
+	for (const ThreadPhaseRecord* record : records) {
+		uint64_t totalTicks = 0;
+		for (const PhaseTotals& phase : record->phases) {
+			totalTicks += phase.exclusiveTicks;
+		}
+		std::cerr << "| thread " << record->threadIndex << ": " << phaseTicksToMs(totalTicks) << " ms\n";
+		for (const PhaseTotals& phase : record->phases) {
+			std::cerr << "|   " << std::left << std::setw(16) << phase.name << std::right
+			          << phaseTicksToMs(phase.inclusiveTicks) << " ms, exclusive " << phaseTicksToMs(phase.exclusiveTicks)
+			          << " ms, " << phase.count << "x";
+			if (phase.instructions)
+				std::cerr << ", " << *phase.instructions << " instructions";
+			if (phase.llcMisses)
+				std::cerr << ", " << *phase.llcMisses << " LLC misses";
+			std::cerr << "\n";
+		}
+	}
+}
+
+void PerfData::printOpCounts() {
+#ifdef OP_COUNTERS
+	OpCounts counts = currentHullContext().getOpCounts();
+	std::cerr << "operation counts:\n";
+	for (size_t i = 0; i < numOpCounters; i++) {
+		std::cerr << "| " << opCounterName(static_cast<OpCounter>(i)) << ": " << counts.values[i] << "\n";
+	}
+	std::cerr << "| recursion depth: max " << counts.maxDepth << ", average " << counts.averageDepth() << "\n";
+	std::cerr << "| discarded per level:";
+	for (size_t level = 0; level < counts.numLevels(); level++) {
+		std::cerr << " " << counts.discardedPerLevel[level];
+	}
+	std::cerr << "\n";
+#endif
+}
+
+void PerfData::writeJson(JsonWriter& json) {
+	json.field("compute_time_ms", std::chrono::duration<double, std::milli>(endTime - startTime).count());
+	if (allocationStats) {
+		json.key("allocations");
+		json.beginObject();
+		json.field("count", allocationStats->numAllocations);
+		json.field("bytes", allocationStats->bytesAllocated);
+		json.field("peak_bytes", allocationStats->peakBytes);
+		json.endObject();
+	}
+	json.key("phases");
+	json.beginArray();
+	for (auto [name, time] : currentHullContext().getIntermediateTimes()) {
+		json.beginObject();
+		json.field("name", name);
+		json.field("time_ms", std::chrono::duration<double, std::milli>(time - startTime).count());
+		json.endObject();
+	}
+	json.endArray();
+
+#ifdef OP_COUNTERS
+	OpCounts counts = currentHullContext().getOpCounts();
+	json.key("op_counts");
+	json.beginObject();
+	for (size_t i = 0; i < numOpCounters; i++) {
+		json.field(opCounterName(static_cast<OpCounter>(i)), counts.values[i]);
+	}
+	json.field("max_recursion_depth", counts.maxDepth);
+	json.field("average_recursion_depth", counts.averageDepth());
+	json.key("discarded_per_level");
+	json.beginArray();
+	for (size_t level = 0; level < counts.numLevels(); level++) {
+		json.value(counts.discardedPerLevel[level]);
+	}
+	json.endArray();
+	json.endObject();
+#endif
+
+	std::vector<const ThreadPhaseRecord*> records = currentHullContext().threadPhases.getRecords();
+	if (records.empty())
+		return;
+	json.key("thread_phases");
+	json.beginArray();
+	for (const ThreadPhaseRecord* record : records) {
+		json.beginObject();
+		json.field("thread", static_cast<uint64_t>(record->threadIndex));
+		json.key("phases");
+		json.beginArray();
+		for (const PhaseTotals& phase : record->phases) {
+			json.beginObject();
+			json.field("name", phase.name);
+			json.field("count", phase.count);
+			json.field("inclusive_ms", phaseTicksToMs(phase.inclusiveTicks));
+			json.field("exclusive_ms", phaseTicksToMs(phase.exclusiveTicks));
+			json.key("instructions");
+			if (phase.instructions) {
+				json.value(*phase.instructions);
+			} else {
+				json.null();
+			}
+			json.key("llc_misses");
+			if (phase.llcMisses) {
+				json.value(*phase.llcMisses);
+			} else {
+				json.null();
+			}
+			json.endObject();
+		}
+		json.endArray();
+		json.endObject();
+	}
+	json.endArray();
+}
+
+void PerfData::writeTrace(JsonWriter& json) {
+	const ThreadPhases& threadPhases = currentHullContext().threadPhases;
+	auto ticksToUs = [&] (uint64_t ticks) {
+		return phaseTicksToMs(ticks > threadPhases.startTicks ? ticks - threadPhases.startTicks : 0) * 1000;
+	};
+	
+	json.beginObject();
+	json.field("displayTimeUnit", "ms");
+	json.key("traceEvents");
+	json.beginArray();
+	for (const ThreadPhaseRecord* record : threadPhases.getRecords()) {
+		json.beginObject();
+		json.field("name", "thread_name");
+		json.field("ph", "M");
+		json.field("pid", static_cast<uint64_t>(1));
+		json.field("tid", static_cast<uint64_t>(record->threadIndex));
+		json.key("args");
+		json.beginObject();
+		json.field("name", "thread " + std::to_string(record->threadIndex));
+		json.endObject();
+		json.endObject();
+		
+		for (const PhaseSpan& span : record->spans) {
+			json.beginObject();
+			json.field("name", span.name);
+			json.field("ph", "X");
+			json.field("pid", static_cast<uint64_t>(1));
+			json.field("tid", static_cast<uint64_t>(record->threadIndex));
+			json.field("ts", ticksToUs(span.startTicks));
+			json.field("dur", ticksToUs(span.endTicks) - ticksToUs(span.startTicks));
+			json.endObject();
+		}
+	}
+	json.endArray();
+	json.endObject();
 }
@@ -1,15 +1,37 @@
 #pragma once
 
+#include "alloc_tracking.hpp"
+
 #include <chrono>
+#include <optional>
+
+struct JsonWriter;
 
 struct PerfData {
 	std::chrono::high_resolution_clock::time_point startTime;
 	std::chrono::high_resolution_clock::time_point endTime;
 	
+	// Counts the heap allocations between begin and end, see alloc_tracking.hpp
+	bool trackAllocations = false;
+	std::optional<AllocationStats> allocationStats;
+	
 	virtual ~PerfData() { }
 	
 	virtual void begin();
 	virtual void end();
 	
 	virtual void printStatistics();
+	
+	// Time and counters per thread and phase, when the current context collects them
+	void printThreadPhases();
+	// Operation counts of the current context, when built with OP_COUNTERS
+	void printOpCounts();
+	
+	// Writes the members of the measurement object in the JSON report: compute time, intermediate times
+	// and whatever the subclass measured
+	virtual void writeJson(JsonWriter& json);
+	
+	// Writes the phase spans of the current context, recorded when its ThreadPhases::recordSpans is set,
+	// as a Chrome trace event file with one track per thread
+	void writeTrace(JsonWriter& json);
 };
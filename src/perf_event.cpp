@@ -0,0 +1,173 @@
+#include "perf_event.hpp"
+#include "json_writer.hpp"
+
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct PerfEventCounter {
+	std::string_view label;
+	std::string_view jsonName;
+	uint32_t type;
+	uint64_t config;
+	int fd = -1;
+	std::optional<uint64_t> value;
+};
+
+static constexpr uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+	return cache | (op << 8) | (result << 16);
+}
+
+static int openCounter(uint32_t type, uint64_t config) {
+	perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.inherit = 1; // also count threads started while the counter is enabled
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+struct PerfEventPerfData : PerfData {
+	std::vector<PerfEventCounter> counters;
+	
+	~PerfEventPerfData() {
+		for (PerfEventCounter& counter : counters) {
+			if (counter.fd >= 0)
+				close(counter.fd);
+		}
+	}
+	
+	void begin() override {
+		for (PerfEventCounter& counter : counters) {
+			if (counter.fd < 0)
+				continue;
+			ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+		PerfData::begin();
+	}
+	
+	void end() override {
+		PerfData::end();
+		for (PerfEventCounter& counter : counters) {
+			if (counter.fd >= 0)
+				ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+		}
+		
+		// When there are more counters than the PMU has slots the kernel multiplexes them,
+		// the values are scaled up to the full measurement time
+		for (PerfEventCounter& counter : counters) {
+			uint64_t values[3];
+			counter.value.reset();
+			if (counter.fd < 0 || read(counter.fd, values, sizeof(values)) != sizeof(values) || values[2] == 0)
+				continue;
+			double scale = values[2] < values[1] ? static_cast<double>(values[1]) / static_cast<double>(values[2]) : 1.0;
+			counter.value = static_cast<uint64_t>(static_cast<double>(values[0]) * scale);
+		}
+	}
+	
+	std::optional<uint64_t> getValue(std::string_view jsonName) const {
+		for (const PerfEventCounter& counter : counters) {
+			if (counter.jsonName == jsonName)
+				return counter.value;
+		}
+		return {};
+	}
+	
+	std::optional<double> getIPC() const {
+		auto cycles = getValue("cycles");
+		auto instructions = getValue("instructions");
+		if (!cycles || !instructions || *cycles == 0)
+			return {};
+		return static_cast<double>(*instructions) / static_cast<double>(*cycles);
+	}
+	
+	void printStatistics() override {
+		PerfData::printStatistics();
+		
+		std::cerr << "perf counters:\n";
+		
+		size_t maxLabelLen = 0;
+		for (const PerfEventCounter& counter : counters) {
+			maxLabelLen = std::max(maxLabelLen, counter.label.size());
+		}
+		for (const PerfEventCounter& counter : counters) {
+			std::string value = counter.fd < 0 ? "not available" : "not counted";
+			if (counter.value) {
+				value = std::to_string(*counter.value);
+				int vlen = value.size();
+				for (int i = 1; i * 3 < vlen; i++) {
+					value.insert(value.begin() + (vlen - i * 3), ',');
+				}
+			}
+			std::cerr << std::string(maxLabelLen + 2 - counter.label.size(), ' ') << counter.label << ": " << value << "\n";
+		}
+		if (auto ipc = getIPC()) {
+			std::cerr << std::string(maxLabelLen + 2 - 15, ' ') << "instr per clock: " << *ipc << "\n";
+		}
+	}
+	
+	void writeJson(JsonWriter& json) override {
+		PerfData::writeJson(json);
+		json.key("perf_events");
+		json.beginObject();
+		for (const PerfEventCounter& counter : counters) {
+			json.key(counter.jsonName);
+			if (counter.value) {
+				json.value(*counter.value);
+			} else {
+				json.null();
+			}
+		}
+		json.endObject();
+	}
+};
+
+std::unique_ptr<PerfData> createPerfEventPerfData() {
+	auto perfData = std::make_unique<PerfEventPerfData>();
+	
+	PerfEventCounter counters[] = {
+		{ "cycles", "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ "instr retired", "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ "branch misses", "branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+		{ "LLC references", "llc_references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+		{ "LLC misses", "llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ "L1D read misses", "l1d_read_misses", PERF_TYPE_HW_CACHE,
+		  cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+		// Software counters, also available in virtual machines without a PMU
+		{ "task clock (ns)", "task_clock_ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+		{ "page faults", "page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+	};
+	
+	std::string unavailable;
+	bool anyOpened = false;
+	for (PerfEventCounter& counter : counters) {
+		counter.fd = openCounter(counter.type, counter.config);
+		if (counter.fd < 0) {
+			unavailable += std::string(unavailable.empty() ? "" : ", ") + std::string(counter.label) + " (" + std::strerror(errno) + ")";
+		}
+		anyOpened |= counter.fd >= 0;
+		perfData->counters.push_back(counter);
+	}
+	
+	if (!unavailable.empty()) {
+		std::cerr << "perf counters not available: " << unavailable << "\n";
+	}
+	if (!anyOpened)
+		return nullptr;
+	return perfData;
+}
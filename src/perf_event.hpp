@@ -0,0 +1,12 @@
+#pragma once
+
+#include "perf_data.hpp"
+
+#include <memory>
+
+// PerfData reading hardware counters through Linux perf_event_open: cycles, instructions, branch misses,
+// last level cache references and misses and L1 data cache read misses, plus task clock and page faults,
+// of this process and the threads it starts while measuring. Only user space is counted, which works
+// without root as long as /proc/sys/kernel/perf_event_paranoid is at most 2. Counters the CPU or kernel
+// do not offer are reported as not available, returns nullptr if none can be opened.
+std::unique_ptr<PerfData> createPerfEventPerfData();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "op_counters.hpp"
+
 #include <cstdint>
 #include <ostream>
 #include <tuple>
@@ -47,6 +49,7 @@ struct point {
 	point rotated90CCW() const { return point(-y, x); };
 	
 	side sideOfLine(point lineStart, point lineEnd, T epsilon = 0) const {
+		countOp(OpCounter::OrientationTests);
 		auto c = cross(lineEnd, lineStart);
 		if (c > epsilon)
 			return side::right;
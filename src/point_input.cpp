@@ -0,0 +1,437 @@
+#include "point_input.hpp"
+
+#include <iostream>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <barrier>
+#include <list>
+#include <algorithm>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static inline bool isSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Counts newlines between begin and end, stopping once maxLines have been found
+static size_t countLines(const char* begin, const char* end, size_t maxLines) {
+	size_t numLines = 0;
+	while (numLines < maxLines && begin != end) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+		if (lineEnd == nullptr)
+			break;
+		begin = lineEnd + 1;
+		numLines++;
+	}
+	return numLines;
+}
+
+PointInput::~PointInput() {
+	if (mapped) {
+		munmap(const_cast<char*>(data), dataSize);
+	}
+}
+
+bool PointInput::tryMap(int fd) {
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+		return false;
+	
+	off_t offset = lseek(fd, 0, SEEK_CUR);
+	if (offset < 0 || offset >= st.st_size)
+		return false;
+	
+	void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (mapping == MAP_FAILED)
+		return false;
+	madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+	
+	data = static_cast<const char*>(mapping);
+	dataSize = st.st_size;
+	dataPos = offset;
+	mapped = true;
+	inMemory = true;
+	return true;
+}
+
+bool PointInput::open(const char* path) {
+	if (path == nullptr) {
+		if (!tryMap(STDIN_FILENO))
+			stream = &std::cin;
+	} else {
+		int fd = ::open(path, O_RDONLY);
+		if (fd < 0) {
+			std::cerr << "failed to open " << path << ": " << std::strerror(errno) << "\n";
+			return false;
+		}
+		bool didMap = tryMap(fd);
+		::close(fd);
+		if (!didMap) {
+			fileStream = std::make_unique<std::ifstream>(path, std::ios::binary);
+			stream = fileStream.get();
+		}
+	}
+	return readHeader();
+}
+
+bool PointInput::openBuffer(const char* buffer, size_t size) {
+	data = buffer;
+	dataSize = size;
+	dataPos = 0;
+	inMemory = true;
+	return readHeader();
+}
+
+bool PointInput::readRaw(void* dst, size_t bytes) {
+	size_t fromData = std::min(bytes, dataSize - dataPos);
+	if (fromData != 0) {
+		std::memcpy(dst, data + dataPos, fromData);
+		dataPos += fromData;
+	}
+	if (fromData == bytes)
+		return true;
+	if (inMemory)
+		return false;
+	stream->read(static_cast<char*>(dst) + fromData, bytes - fromData);
+	return static_cast<size_t>(stream->gcount()) == bytes - fromData;
+}
+
+bool PointInput::readHeader() {
+	char c0;
+	if (!readRaw(&c0, 1)) {
+		std::cerr << "input is empty\n";
+		return false;
+	}
+	
+	if (c0 == 'B' || c0 == 'I') {
+		format = c0 == 'B' ? InputFormat::Binary : InputFormat::BinaryInt;
+		if (!readRaw(&numPoints, sizeof(numPoints))) {
+			std::cerr << "binary input is missing the point count\n";
+			return false;
+		}
+		if (inMemory && (dataSize - dataPos) / sizeof(pointd) < numPoints) {
+			std::cerr << "binary input is truncated, expected " << numPoints << " points\n";
+			return false;
+		}
+	} else if (c0 == '2') {
+		format = InputFormat::Text;
+		if (!inMemory) {
+			bufferTextLines(2);
+		}
+		const char* end = data + dataSize;
+		const char* lineEnd = static_cast<const char*>(std::memchr(data + dataPos, '\n', end - (data + dataPos)));
+		const char* numBegin = lineEnd == nullptr ? end : lineEnd + 1;
+		auto [numEnd, ec] = std::from_chars(numBegin, end, numPoints);
+		lineEnd = static_cast<const char*>(std::memchr(numBegin, '\n', end - numBegin));
+		const char* countEnd = lineEnd == nullptr ? end : lineEnd;
+		if (ec != std::errc() || !std::all_of(numEnd, countEnd, isSpace)) {
+			std::cerr << "text input is missing the point count on its second line\n";
+			return false;
+		}
+		dataPos = (lineEnd == nullptr ? end : lineEnd + 1) - data;
+		// The shortest point line is "0 0\n", the last one may lack its newline
+		if (inMemory && (dataSize - dataPos + 1) / 4 < numPoints) {
+			std::cerr << "text input is truncated, expected " << numPoints << " points\n";
+			return false;
+		}
+	} else {
+		std::cerr << "unexpected first character " << c0 << ", expected 2, B or I\n";
+		return false;
+	}
+	return true;
+}
+
+bool PointInput::nextRecord() {
+	while (true) {
+		while (dataPos < dataSize && isSpace(data[dataPos]))
+			dataPos++;
+		if (dataPos < dataSize)
+			return readHeader();
+		if (inMemory)
+			return false;
+		
+		int c = stream->peek();
+		if (c == std::char_traits<char>::eof())
+			return false;
+		if (!isSpace(static_cast<char>(c)))
+			return readHeader();
+		stream->get();
+	}
+}
+
+template <typename T, typename U>
+static point<T> convertPoint(point<U> p) {
+	if constexpr (std::is_integral_v<T> && !std::is_integral_v<U>) {
+		p.x = std::round(p.x);
+		p.y = std::round(p.y);
+	}
+	return point<T>(p);
+}
+
+// Integer coordinates are parsed natively. Values written with a fractional part or exponent
+// are reparsed as doubles and rounded, which matches how the double parser handles them.
+template <typename T>
+static const char* parseCoordinate(const char* pos, const char* end, T& out) {
+	while (pos != end && isSpace(*pos))
+		pos++;
+	const char* numEnd = std::from_chars(pos, end, out).ptr;
+	if constexpr (std::is_integral_v<T>) {
+		if (numEnd != end && (*numEnd == '.' || *numEnd == 'e' || *numEnd == 'E')) {
+			double value;
+			numEnd = std::from_chars(pos, end, value).ptr;
+			out = static_cast<T>(std::round(value));
+		}
+	}
+	return numEnd;
+}
+
+template <typename T>
+static const char* parseTextPoint(const char* pos, const char* end, point<T>& out) {
+	pos = parseCoordinate(pos, end, out.x);
+	pos = parseCoordinate(pos, end, out.y);
+	const char* lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+	return lineEnd == nullptr ? end : lineEnd + 1;
+}
+
+// The consumed part of textBuffer is only dropped when more input has to be read,
+// so reading many small records does not move the buffered text around for each one.
+// Returns false if the stream ended before numLines lines, counting a last line without newline.
+bool PointInput::bufferTextLines(size_t numLines) {
+	constexpr size_t BLOCK_SIZE = 1 << 20;
+	size_t numBufferedLines = countLines(textBuffer.data() + dataPos, textBuffer.data() + textBuffer.size(), numLines);
+	if (numBufferedLines < numLines && *stream) {
+		textBuffer.erase(textBuffer.begin(), textBuffer.begin() + dataPos);
+		dataPos = 0;
+		while (numBufferedLines < numLines && *stream) {
+			size_t size = textBuffer.size();
+			textBuffer.resize(size + BLOCK_SIZE);
+			stream->read(textBuffer.data() + size, BLOCK_SIZE);
+			textBuffer.resize(size + stream->gcount());
+			numBufferedLines += countLines(textBuffer.data() + size, textBuffer.data() + textBuffer.size(), numLines - numBufferedLines);
+		}
+	}
+	data = textBuffer.data();
+	dataSize = textBuffer.size();
+	if (numBufferedLines >= numLines)
+		return true;
+	if (numBufferedLines + 1 < numLines)
+		return false;
+	
+	const char* end = data + dataSize;
+	const char* lastLine = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(data + dataPos), '\n').base();
+	return std::any_of(lastLine, end, [] (char c) { return !isSpace(c); });
+}
+
+void PointInput::releaseConsumed() {
+	if (mapped) {
+		size_t pageSize = sysconf(_SC_PAGESIZE);
+		size_t releaseEnd = dataPos & ~(pageSize - 1);
+		if (releaseEnd > releasedBytes) {
+			madvise(const_cast<char*>(data) + releasedBytes, releaseEnd - releasedBytes, MADV_DONTNEED);
+			releasedBytes = releaseEnd;
+		}
+	}
+}
+
+// Moves pos to the start of the next line unless it is there already, so that a parse window never
+// ends in the middle of a line, whose start would otherwise be parsed as a whole point
+static const char* extendToLineEnd(const char* begin, const char* pos, const char* end) {
+	if (pos == begin || pos == end || pos[-1] == '\n')
+		return pos;
+	const char* lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+	return lineEnd == nullptr ? end : lineEnd + 1;
+}
+
+// Guesses where the text for numLines lines ends from the average length of the first lines.
+// The guess is generous, parseTextPointsParallel asks for a larger window if it was too small.
+static const char* estimateLinesEnd(const char* begin, const char* end, size_t numLines) {
+	constexpr size_t NUM_SAMPLE_LINES = 256;
+	const char* pos = begin;
+	size_t numSampled = 0;
+	while (numSampled < std::min(numLines, NUM_SAMPLE_LINES) && pos != end) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+		pos = lineEnd == nullptr ? end : lineEnd + 1;
+		numSampled++;
+	}
+	if (pos == end || numSampled == numLines)
+		return pos;
+	double bytesPerLine = static_cast<double>(pos - begin) / static_cast<double>(numSampled);
+	size_t estimate = static_cast<size_t>(bytesPerLine * 1.25 * static_cast<double>(numLines)) + 4096;
+	return estimate >= static_cast<size_t>(end - begin) ? end : extendToLineEnd(begin, begin + estimate, end);
+}
+
+template <typename T>
+struct AOSPointStore {
+	using coord_type = T;
+	std::span<point<T>> points;
+	
+	size_t size() const { return points.size(); }
+	
+	template <typename U>
+	void store(size_t i, point<U> p) { points[i] = convertPoint<T>(p); }
+};
+
+template <typename T>
+struct SOAPointStore {
+	using coord_type = T;
+	std::span<T> x;
+	std::span<T> y;
+	
+	size_t size() const { return x.size(); }
+	
+	template <typename U>
+	void store(size_t i, point<U> p) {
+		point<T> converted = convertPoint<T>(p);
+		x[i] = converted.x;
+		y[i] = converted.y;
+	}
+};
+
+// Splits the text into one newline aligned chunk per thread. Each thread first counts the lines
+// in its chunk, then after a barrier parses its lines straight into their final positions.
+// Returns a pointer to the first character after the last line that was parsed, or nullptr if
+// the text ends before all points were found and end is not the end of the input.
+template <typename Store>
+static const char* parseTextPointsParallel(const char* begin, const char* end, bool isInputEnd, Store& points, size_t numThreads) {
+	std::vector<const char*> chunkBegin(numThreads + 1);
+	chunkBegin[0] = begin;
+	chunkBegin[numThreads] = end;
+	for (size_t t = 1; t < numThreads; t++) {
+		const char* pos = std::max(chunkBegin[t - 1], begin + (end - begin) / numThreads * t);
+		const char* lineEnd = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+		chunkBegin[t] = lineEnd == nullptr ? end : lineEnd + 1;
+	}
+	
+	std::vector<size_t> numLines(numThreads);
+	std::vector<const char*> parseEnd(numThreads, nullptr);
+	std::barrier barrier(numThreads);
+	
+	auto threadTarget = [&] (size_t t) {
+		const char* chunkEnd = chunkBegin[t + 1];
+		size_t lines = 0;
+		for (const char* pos = chunkBegin[t]; pos != chunkEnd; lines++) {
+			const char* lineEnd = static_cast<const char*>(std::memchr(pos, '\n', chunkEnd - pos));
+			pos = lineEnd == nullptr ? chunkEnd : lineEnd + 1;
+		}
+		numLines[t] = lines;
+		
+		barrier.arrive_and_wait();
+		
+		size_t firstLine = 0;
+		for (size_t i = 0; i < t; i++)
+			firstLine += numLines[i];
+		
+		size_t totalLines = firstLine;
+		for (size_t i = t; i < numThreads; i++)
+			totalLines += numLines[i];
+		if (totalLines < points.size() && !isInputEnd)
+			return;
+		
+		const char* pos = chunkBegin[t];
+		for (size_t i = firstLine; i < std::min<size_t>(firstLine + lines, points.size()); i++) {
+			point<typename Store::coord_type> p;
+			pos = parseTextPoint(pos, chunkEnd, p);
+			points.store(i, p);
+		}
+		if (firstLine + lines >= points.size() && firstLine <= points.size())
+			parseEnd[t] = pos;
+	};
+	
+	std::list<std::thread> threads;
+	for (size_t t = 1; t < numThreads; t++) {
+		threads.emplace_back(threadTarget, t);
+	}
+	threadTarget(0);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	
+	auto it = std::find_if(parseEnd.begin(), parseEnd.end(), [] (const char* p) { return p != nullptr; });
+	if (it != parseEnd.end())
+		return *it;
+	return isInputEnd ? end : nullptr;
+}
+
+// Streams are only known to be short once they run out, mapped and buffered input is checked by readHeader
+bool PointInput::reportTruncated() {
+	std::cerr << (format == InputFormat::Text ? "text" : "binary") << " input is truncated, expected " << numPoints << " points\n";
+	truncated = true;
+	return false;
+}
+
+template <typename U, typename Store>
+bool PointInput::readBinaryInto(Store& points) {
+	std::vector<point<U>> buffer(std::min<size_t>(points.size(), 4096));
+	for (size_t i = 0; i < points.size(); i += buffer.size()) {
+		size_t count = std::min(buffer.size(), points.size() - i);
+		if (!readRaw(buffer.data(), count * sizeof(point<U>)))
+			return reportTruncated();
+		for (size_t j = 0; j < count; j++) {
+			points.store(i + j, buffer[j]);
+		}
+	}
+	return true;
+}
+
+template <typename Store>
+bool PointInput::readInto(Store& points) {
+	if (format == InputFormat::Binary)
+		return readBinaryInto<double>(points);
+	if (format == InputFormat::BinaryInt)
+		return readBinaryInto<int64_t>(points);
+	
+	if (!inMemory && !bufferTextLines(points.size()))
+		return reportTruncated();
+	
+	const char* pos = data + dataPos;
+	const char* end = data + dataSize;
+	const char* windowEnd = estimateLinesEnd(pos, end, points.size());
+	
+	constexpr size_t MIN_BYTES_PER_THREAD = 1 << 20;
+	size_t maxThreads = numReadThreads ? numReadThreads : std::thread::hardware_concurrency();
+	size_t numThreads = std::clamp<size_t>((windowEnd - pos) / MIN_BYTES_PER_THREAD, 1, std::max<size_t>(maxThreads, 1));
+	if (numThreads > 1) {
+		while (true) {
+			const char* parseEnd = parseTextPointsParallel(pos, windowEnd, windowEnd == end, points, numThreads);
+			if (parseEnd != nullptr) {
+				pos = parseEnd;
+				break;
+			}
+			windowEnd = extendToLineEnd(pos, pos + std::min<size_t>((windowEnd - pos) * 2, end - pos), end);
+		}
+	} else {
+		for (size_t i = 0; i < points.size(); i++) {
+			point<typename Store::coord_type> p;
+			pos = parseTextPoint(pos, end, p);
+			points.store(i, p);
+		}
+	}
+	dataPos = pos - data;
+	return true;
+}
+
+template <typename T>
+bool PointInput::readPoints(std::span<point<T>> points) {
+	if (format == binaryFormatFor<T>())
+		return readRaw(points.data(), points.size_bytes()) || reportTruncated();
+	AOSPointStore<T> store { points };
+	return readInto(store);
+}
+
+template <typename T>
+bool PointInput::readPointsSOA(std::span<T> x, std::span<T> y) {
+	SOAPointStore<T> store { x, y };
+	return readInto(store);
+}
+
+template bool PointInput::readPoints<int64_t>(std::span<point<int64_t>> points);
+template bool PointInput::readPoints<double>(std::span<point<double>> points);
+template bool PointInput::readPointsSOA<int64_t>(std::span<int64_t> x, std::span<int64_t> y);
+template bool PointInput::readPointsSOA<double>(std::span<double> x, std::span<double> y);
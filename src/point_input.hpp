@@ -0,0 +1,85 @@
+#pragma once
+
+#include "point.hpp"
+
+#include <cstdint>
+#include <type_traits>
+#include <span>
+#include <memory>
+#include <fstream>
+#include <vector>
+
+enum class InputFormat {
+	Text,
+	Binary,   // 'B', uint64 point count, then pairs of doubles
+	BinaryInt // 'I', uint64 point count, then pairs of int64
+};
+
+template <typename T>
+constexpr InputFormat binaryFormatFor() {
+	return std::is_integral_v<T> ? InputFormat::BinaryInt : InputFormat::Binary;
+}
+
+// Reads the point input, either from stdin or from a file given by path.
+// When the input is a regular file it is memory mapped and points are copied
+// straight out of the page cache instead of going through iostream buffers.
+// Text input that is not mapped is buffered in memory as far as the requested
+// points need, after which both cases are parsed in parallel by numReadThreads threads.
+struct PointInput {
+	InputFormat format = InputFormat::Text;
+	uint64_t numPoints = 0;
+	size_t numReadThreads = 0; // 0 means use all hardware threads
+	
+	PointInput() = default;
+	PointInput(const PointInput&) = delete;
+	PointInput& operator=(const PointInput&) = delete;
+	~PointInput();
+	
+	// Opens the input and reads the header. path == nullptr reads from stdin.
+	bool open(const char* path);
+	
+	// Reads from a buffer that holds the whole input and outlives the PointInput
+	bool openBuffer(const char* buffer, size_t size);
+	
+	// Reads the header of the next record for inputs holding several point sets back to back.
+	// Returns false at the end of the input.
+	bool nextRecord();
+	
+	bool isMapped() const { return mapped; }
+	
+	// Both return false, after reporting it, if binary input ends before all points were read
+	template <typename T>
+	bool readPoints(std::span<point<T>> points);
+	
+	// Reads directly into separate x and y arrays, for SOA implementations
+	template <typename T>
+	bool readPointsSOA(std::span<T> x, std::span<T> y);
+	
+	// Lets the kernel drop mapped pages that have already been read
+	void releaseConsumed();
+	
+	std::istream* stream = nullptr;
+	std::unique_ptr<std::ifstream> fileStream;
+	
+	// Either the memory mapped file, a buffer given to openBuffer or the input buffered in textBuffer
+	const char* data = nullptr;
+	size_t dataSize = 0;
+	size_t dataPos = 0;
+	bool mapped = false;
+	bool inMemory = false; // data holds the whole input, nothing is left to read from stream
+	bool truncated = false; // input read from a stream ended before numPoints points
+	size_t releasedBytes = 0;
+	std::vector<char> textBuffer;
+	
+	bool tryMap(int fd);
+	bool readHeader();
+	bool bufferTextLines(size_t numLines);
+	bool readRaw(void* dst, size_t bytes);
+	bool reportTruncated();
+	
+	template <typename U, typename Store>
+	bool readBinaryInto(Store& points);
+	
+	template <typename Store>
+	bool readInto(Store& points);
+};
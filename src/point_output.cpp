@@ -0,0 +1,72 @@
+#include "point_output.hpp"
+#include "point_input.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <vector>
+
+// Text is formatted with to_chars into a large buffer that is flushed when it fills up,
+// doubles are printed the same way as std::fixed with precision 15.
+template <typename T>
+static void writeHullText(std::ostream& stream, std::span<point<T>> hull) {
+	constexpr size_t BUFFER_SIZE = 1 << 20;
+	constexpr size_t MAX_LINE_LENGTH = 1024;
+	
+	std::vector<char> buffer(BUFFER_SIZE);
+	char* bufferEnd = buffer.data() + buffer.size();
+	char* pos = buffer.data();
+	
+	auto writeCoordinate = [&] (T value) {
+		if constexpr (std::is_integral_v<T>) {
+			pos = std::to_chars(pos, bufferEnd, value).ptr;
+		} else {
+			pos = std::to_chars(pos, bufferEnd, value, std::chars_format::fixed, 15).ptr;
+		}
+	};
+	
+	pos = std::copy_n("on hull: ", 9, pos);
+	pos = std::to_chars(pos, bufferEnd, hull.size()).ptr;
+	*(pos++) = '\n';
+	
+	bool anyNotFinite = false;
+	for (const point<T>& p : hull) {
+		if (bufferEnd - pos < static_cast<ptrdiff_t>(MAX_LINE_LENGTH)) {
+			stream.write(buffer.data(), pos - buffer.data());
+			pos = buffer.data();
+		}
+		if constexpr (!std::is_integral_v<T>) {
+			anyNotFinite |= !std::isfinite(p.x) || !std::isfinite(p.y);
+		}
+		writeCoordinate(p.x);
+		*(pos++) = ' ';
+		writeCoordinate(p.y);
+		*(pos++) = '\n';
+	}
+	stream.write(buffer.data(), pos - buffer.data());
+	
+	if (anyNotFinite) {
+		std::cerr << "output contains inf/nan!\n";
+	}
+}
+
+template <typename T>
+static void writeHullBinary(std::ostream& stream, std::span<point<T>> hull) {
+	stream.put(binaryFormatFor<T>() == InputFormat::BinaryInt ? 'I' : 'B');
+	uint64_t numPoints = hull.size();
+	stream.write(reinterpret_cast<const char*>(&numPoints), sizeof(numPoints));
+	stream.write(reinterpret_cast<const char*>(hull.data()), hull.size_bytes());
+}
+
+template <typename T>
+void writeHull(std::ostream& stream, std::span<point<T>> hull, OutputFormat format) {
+	std::rotate(hull.begin(), std::min_element(hull.begin(), hull.end()), hull.end());
+	if (format == OutputFormat::Binary) {
+		writeHullBinary(stream, hull);
+	} else {
+		writeHullText(stream, hull);
+	}
+}
+
+template void writeHull<int64_t>(std::ostream& stream, std::span<point<int64_t>> hull, OutputFormat format);
+template void writeHull<double>(std::ostream& stream, std::span<point<double>> hull, OutputFormat format);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "point.hpp"
+
+#include <ostream>
+#include <span>
+
+enum class OutputFormat {
+	Text,  // "on hull: N" followed by one "x y" line per point
+	Binary // same layout as the binary input: 'B' or 'I', uint64 point count, then the points
+};
+
+// Writes the hull points, starting from the lexicographically smallest one.
+template <typename T>
+void writeHull(std::ostream& stream, std::span<point<T>> hull, OutputFormat format);
@@ -0,0 +1,315 @@
+#include "server.hpp"
+#include "hull_impl.hpp"
+#include "point_input.hpp"
+#include "point_output.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+template <typename T>
+struct WarmBuffers {
+	std::vector<point<T>> points;
+	SOABuffer<T> soa;
+};
+
+// Larger payloads are refused before anything is allocated for them (128M points in binary)
+constexpr size_t MAX_PAYLOAD_SIZE = size_t(1) << 31;
+
+struct Connection {
+	int inFd;
+	int outFd;
+	size_t numReadThreads;
+	
+	std::vector<char> readBuffer = std::vector<char>(1 << 16);
+	size_t readPos = 0;
+	size_t readEnd = 0;
+	
+	std::vector<char> payload;
+	std::ostringstream body;
+	WarmBuffers<int64_t> intBuffers;
+	WarmBuffers<double> doubleBuffers;
+	
+	bool fill();
+	bool readLine(std::string& line);
+	bool readPayload(size_t size);
+	bool writeAll(const char* data, size_t size);
+	bool reply(std::string_view status, std::string_view extra, std::string_view content);
+	bool serveRequest();
+};
+
+bool Connection::fill() {
+	if (readPos == readEnd) {
+		readPos = readEnd = 0;
+	} else if (readEnd == readBuffer.size()) {
+		if (readPos == 0) {
+			readBuffer.resize(readBuffer.size() * 2);
+		} else {
+			std::memmove(readBuffer.data(), readBuffer.data() + readPos, readEnd - readPos);
+			readEnd -= readPos;
+			readPos = 0;
+		}
+	}
+	ssize_t numRead = ::read(inFd, readBuffer.data() + readEnd, readBuffer.size() - readEnd);
+	if (numRead <= 0)
+		return false;
+	readEnd += numRead;
+	return true;
+}
+
+bool Connection::readLine(std::string& line) {
+	size_t searchPos = readPos;
+	while (true) {
+		const char* begin = readBuffer.data() + readPos;
+		const char* newline = static_cast<const char*>(std::memchr(readBuffer.data() + searchPos, '\n', readEnd - searchPos));
+		if (newline != nullptr) {
+			line.assign(begin, newline);
+			readPos = newline + 1 - readBuffer.data();
+			return true;
+		}
+		size_t searched = readEnd - readPos;
+		if (!fill())
+			return false;
+		searchPos = readPos + searched;
+	}
+}
+
+bool Connection::readPayload(size_t size) {
+	payload.resize(size);
+	size_t buffered = std::min(size, readEnd - readPos);
+	std::memcpy(payload.data(), readBuffer.data() + readPos, buffered);
+	readPos += buffered;
+	for (size_t pos = buffered; pos < size;) {
+		ssize_t numRead = ::read(inFd, payload.data() + pos, size - pos);
+		if (numRead <= 0)
+			return false;
+		pos += numRead;
+	}
+	return true;
+}
+
+bool Connection::writeAll(const char* data, size_t size) {
+	while (size != 0) {
+		ssize_t numWritten = ::write(outFd, data, size);
+		if (numWritten <= 0)
+			return false;
+		data += numWritten;
+		size -= numWritten;
+	}
+	return true;
+}
+
+bool Connection::reply(std::string_view status, std::string_view extra, std::string_view content) {
+	std::string header(status);
+	header += ' ';
+	header += std::to_string(content.size());
+	if (!extra.empty()) {
+		header += ' ';
+		header += extra;
+	}
+	header += '\n';
+	return writeAll(header.data(), header.size()) && writeAll(content.data(), content.size());
+}
+
+template <typename T>
+static double solveRequest(PointInput& input, HullSolveFunction<T> run, HullSolveFunctionSOA<T> runSoa,
+                           size_t soaAlignment, std::string_view args, WarmBuffers<T>& buffers) {
+	std::vector<point<T>>& points = buffers.points;
+	if (runSoa) {
+		SOABuffer<T>& soa = buffers.soa;
+		soa.resize(input.numPoints, soaAlignment);
+		input.readPointsSOA<T>({ soa.x, soa.numPoints }, { soa.y, soa.numPoints });
+	} else {
+		points.resize(input.numPoints);
+		input.readPoints<T>(points);
+	}
+	
+	HullContext context(args);
+	HullContextScope contextScope(context);
+	auto startTime = std::chrono::high_resolution_clock::now();
+	if (runSoa) {
+		size_t numHullPoints = runSoa(buffers.soa.points());
+		points.resize(numHullPoints);
+		for (size_t i = 0; i < numHullPoints; i++) {
+			points[i] = point<T>(buffers.soa.x[i], buffers.soa.y[i]);
+		}
+	} else {
+		run(points);
+	}
+	auto endTime = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+template <typename T>
+static void writeBody(std::ostream& body, std::vector<point<T>>& hull, bool outputPoints, OutputFormat outputFormat) {
+	if (outputPoints) {
+		writeHull<T>(body, hull, outputFormat);
+	} else {
+		body << "on hull: " << hull.size() << "\n";
+	}
+}
+
+// Returns false when the connection should be closed, either because the client is done
+// or because the request could not be framed and the stream cannot be resynchronised.
+bool Connection::serveRequest() {
+	std::string line;
+	if (!readLine(line))
+		return false;
+	
+	std::string_view implName;
+	std::string_view args;
+	size_t payloadSize = 0;
+	bool hasPayloadSize = false;
+	bool useIntVersion = false;
+	bool outputPoints = true;
+	OutputFormat outputFormat = OutputFormat::Text;
+	
+	std::string_view rest = line;
+	while (!rest.empty()) {
+		size_t tokenEnd = std::min(rest.find(' '), rest.size());
+		std::string_view token = rest.substr(0, tokenEnd);
+		rest.remove_prefix(std::min(tokenEnd + 1, rest.size()));
+		if (token.empty()) {
+			continue;
+		} else if (token == "-i") {
+			useIntVersion = true;
+		} else if (token == "-q") {
+			outputPoints = false;
+		} else if (token == "-ob") {
+			outputFormat = OutputFormat::Binary;
+		} else if (implName.empty()) {
+			implName = token;
+		} else if (!hasPayloadSize) {
+			auto result = std::from_chars(token.data(), token.data() + token.size(), payloadSize);
+			hasPayloadSize = result.ec == std::errc() && result.ptr == token.data() + token.size();
+			if (!hasPayloadSize)
+				break;
+		}
+	}
+	if (!hasPayloadSize) {
+		reply("error", "", "malformed request, expected <implementation> <payload bytes>\n");
+		return false;
+	}
+	// The payload is not read in both cases, so the stream is out of frame afterwards
+	if (payloadSize > MAX_PAYLOAD_SIZE) {
+		reply("error", "", "payload of " + std::to_string(payloadSize) + " bytes is larger than the limit of " + std::to_string(MAX_PAYLOAD_SIZE) + "\n");
+		return false;
+	}
+	try {
+		if (!readPayload(payloadSize))
+			return false;
+	} catch (const std::bad_alloc&) {
+		reply("error", "", "out of memory for a payload of " + std::to_string(payloadSize) + " bytes\n");
+		return false;
+	}
+	
+	size_t colonPos = implName.find(':');
+	if (colonPos != std::string_view::npos) {
+		args = implName.substr(colonPos + 1);
+		implName = implName.substr(0, colonPos);
+	}
+	
+	auto implIterator = std::find_if(
+		hullImplementations->begin(), hullImplementations->end(),
+		[&] (const HullImpl& impl) { return impl.name == implName; });
+	if (implIterator == hullImplementations->end()) {
+		return reply("error", "", "implementation not found: " + std::string(implName) + "\n");
+	}
+	if (useIntVersion ? (!implIterator->runInt && !implIterator->runIntSoa) : (!implIterator->runDouble && !implIterator->runDoubleSoa)) {
+		return reply("error", "", std::string(useIntVersion ? "integer" : "double") + " implementation not available for " + std::string(implName) + "\n");
+	}
+	
+	PointInput input;
+	input.numReadThreads = numReadThreads;
+	if (!input.openBuffer(payload.data(), payload.size())) {
+		return reply("error", "", "invalid point payload\n");
+	}
+	if (input.numPoints < MIN_HULL_POINTS) {
+		return reply("error", "", "payload has " + std::to_string(input.numPoints) + " points, at least " + std::to_string(MIN_HULL_POINTS) + " are needed\n");
+	}
+	
+	body.str("");
+	double computeTimeMs;
+	// The payload is already consumed, so a failed request leaves the stream framed and the
+	// connection can go on with the next one
+	try {
+		if (useIntVersion) {
+			computeTimeMs = solveRequest<int64_t>(input, implIterator->runInt, implIterator->runIntSoa,
+			                                      implIterator->soaAlignment, args, intBuffers);
+			writeBody<int64_t>(body, intBuffers.points, outputPoints, outputFormat);
+		} else {
+			computeTimeMs = solveRequest<double>(input, implIterator->runDouble, implIterator->runDoubleSoa,
+			                                     implIterator->soaAlignment, args, doubleBuffers);
+			writeBody<double>(body, doubleBuffers.points, outputPoints, outputFormat);
+		}
+	} catch (const std::exception& e) {
+		return reply("error", "", "request failed: " + std::string(e.what()) + "\n");
+	}
+	
+	return reply("ok", std::to_string(computeTimeMs), body.view());
+}
+
+static size_t serveConnection(Connection& connection) {
+	size_t numRequests = 0;
+	while (connection.serveRequest()) {
+		numRequests++;
+	}
+	return numRequests;
+}
+
+int runServer(const char* socketPath, size_t numReadThreads) {
+	// A client that disconnects early must not take the server down with it
+	std::signal(SIGPIPE, SIG_IGN);
+	
+	if (socketPath == nullptr) {
+		Connection connection { .inFd = STDIN_FILENO, .outFd = STDOUT_FILENO, .numReadThreads = numReadThreads };
+		size_t numRequests = serveConnection(connection);
+		std::cerr << "requests: " << numRequests << "\n";
+		return 0;
+	}
+	
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (std::strlen(socketPath) >= sizeof(address.sun_path)) {
+		std::cerr << "socket path is too long: " << socketPath << "\n";
+		return 1;
+	}
+	std::strcpy(address.sun_path, socketPath);
+	
+	int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	::unlink(socketPath);
+	if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listenFd, 64) != 0) {
+		std::cerr << "failed to listen on " << socketPath << ": " << std::strerror(errno) << "\n";
+		return 1;
+	}
+	std::cerr << "listening on " << socketPath << "\n";
+	
+	while (true) {
+		int fd = ::accept(listenFd, nullptr, nullptr);
+		if (fd < 0) {
+			if (errno == EINTR)
+				continue;
+			std::cerr << "accept failed: " << std::strerror(errno) << "\n";
+			return 1;
+		}
+		std::thread([fd, numReadThreads] {
+			Connection connection { .inFd = fd, .outFd = fd, .numReadThreads = numReadThreads };
+			serveConnection(connection);
+			::close(fd);
+		}).detach();
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+// Long running mode that answers hull requests one after another, so that callers do not pay
+// for starting a process, and point and SOA buffers stay allocated between requests.
+//
+// Every request is a text line
+//   <implementation>[:args] <payload bytes> [-i] [-q] [-ob]
+// followed by exactly that many payload bytes holding one point set in any input format (text, B or I).
+// -i, -q and -ob have the same meaning as on the command line. The reply is a line
+//   ok <body bytes> <compute ms>
+// or
+//   error <body bytes>
+// followed by the body, which is the hull as ch.bin would print it, or the error message.
+//
+// With socketPath == nullptr requests are read from stdin and replies written to stdout until stdin
+// is closed. Otherwise the server listens on a Unix domain socket at socketPath and serves every
+// connection on its own thread, each request with its own HullContext. Returns the process exit code.
+int runServer(const char* socketPath, size_t numReadThreads);
@@ -45,6 +45,7 @@ struct SliceParallelSolver_SplitByDirection : SliceParallelSolver<T> {
 		double angle = M_PI * 2 * (double)threadIndex / (double)this->args.numThreads - M_PI;
 		pointd direction(std::cos(angle), std::sin(angle));
 		
+		PhaseScope phase("extreme search");
 		std::tuple<double, point<T>, size_t> maxValue(-INFINITY, point<T>(), 0);
 		for (size_t i = 0; i < this->points.size(); i++) {
 			double dot = direction.dot(this->points[i]);
@@ -53,7 +54,9 @@ struct SliceParallelSolver_SplitByDirection : SliceParallelSolver<T> {
 		
 		maxPointIndices[threadIndex] = std::get<2>(maxValue);
 		
+		phase.switchTo("barrier");
 		this->barrier.arrive_and_wait();
+		phase.stop();
 		
 		size_t maxPointIndexR = maxPointIndices[threadIndex];
 		size_t maxPointIndexL = maxPointIndices[(threadIndex + 1) % this->args.numThreads];
@@ -63,6 +66,7 @@ struct SliceParallelSolver_SplitByDirection : SliceParallelSolver<T> {
 		point<T> maxPointR = this->points[maxPointIndexR];
 		point<T> maxPointL = this->points[maxPointIndexL];
 		
+		phase.switchTo("partition");
 		std::vector<point<T>> pointsInSlice;
 		for (const point<T> point : this->points) {
 			if (point.sideOfLine(maxPointR, maxPointL) == side::right) {
@@ -72,7 +76,9 @@ struct SliceParallelSolver_SplitByDirection : SliceParallelSolver<T> {
 		pointsInSlice.push_back(maxPointL);
 		pointsInSlice.push_back(maxPointR);
 		
+		phase.switchTo("recursion");
 		this->innerSolve(pointsInSlice);
+		phase.stop();
 		
 		std::rotate(pointsInSlice.begin(), std::find(pointsInSlice.begin(), pointsInSlice.end(), maxPointR), pointsInSlice.end());
 		pointsInSlice.pop_back();
@@ -81,6 +87,7 @@ struct SliceParallelSolver_SplitByDirection : SliceParallelSolver<T> {
 	}
 	
 	std::vector<point<T>> finish() {
+		PhaseScope phase("merge");
 		std::vector<point<T>> result;
 		for (size_t i = 0; i < this->args.numThreads; i++) {
 			result.insert(result.end(), pointsInSlices[i].begin(), pointsInSlices[i].end());
@@ -112,12 +119,20 @@ void solveSliceParallel(std::vector<point<T>>& points, const HullSolveFunction<T
 	solver->innerSolve = innerSolve;
 	
 	std::list<std::thread> threads;
+	HullContext& context = currentHullContext();
 	for (size_t ti = 0; ti < args.numThreads; ti++) {
-		threads.emplace_back([ti, _solver=solver.get()] { _solver->threadTarget(ti); });
+		threads.emplace_back([ti, _solver=solver.get(), &context] {
+			HullContextScope contextScope(context);
+			PhaseScope phase("task");
+			_solver->threadTarget(ti);
+		});
 	}
 	
-	for (std::thread& thread : threads) {
-		thread.join();
+	{
+		PhaseScope phase("join");
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
 	}
 	
 	std::vector<point<T>> result = solver->finish();
@@ -1,5 +1,8 @@
 #include "soa_points.hpp"
 
+#include <algorithm>
+#include <cstddef>
+
 template <typename T>
 size_t SOAPoints<T>::findMinIndex() const {
 	size_t minPointIdx = 0;
@@ -30,5 +33,41 @@ size_t SOAPoints<T>::findMaxIndex() const {
 	return maxPointIdx;
 }
 
+template <typename T>
+size_t SOABuffer<T>::alignmentFor(size_t soaAlignment) {
+	return std::max<size_t>(soaAlignment, alignof(std::max_align_t));
+}
+
+template <typename T>
+size_t SOABuffer<T>::paddedSize(size_t numPoints, size_t soaAlignment) {
+	size_t alignment = alignmentFor(soaAlignment);
+	return (numPoints + alignment) & ~(alignment - 1);
+}
+
+template <typename T>
+void SOABuffer<T>::resize(size_t newNumPoints, size_t soaAlignment) {
+	size_t newAlignment = alignmentFor(soaAlignment);
+	size_t numPointsRoundedUp = paddedSize(newNumPoints, soaAlignment);
+	size_t pointsBytes = numPointsRoundedUp * sizeof(T);
+	
+	if (pointsBytes * 2 > capacityBytes || newAlignment != alignment) {
+		std::free(memory);
+		memory = static_cast<char*>(std::aligned_alloc(newAlignment, pointsBytes * 2));
+		capacityBytes = pointsBytes * 2;
+		alignment = newAlignment;
+	}
+	
+	numPoints = newNumPoints;
+	x = reinterpret_cast<T*>(memory);
+	y = reinterpret_cast<T*>(memory + pointsBytes);
+	for (size_t i = numPoints; i < numPointsRoundedUp; i++) {
+		x[i] = point<T>::notOnHull.x;
+		y[i] = point<T>::notOnHull.y;
+	}
+}
+
 template struct SOAPoints<int64_t>;
 template struct SOAPoints<double>;
+
+template struct SOABuffer<int64_t>;
+template struct SOABuffer<double>;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <span>
+#include <cstdlib>
 
 #include "point.hpp"
 
@@ -39,3 +40,31 @@ struct SOAPoints {
 	size_t findMinIndex() const;
 	size_t findMaxIndex() const;
 };
+
+// Owns the aligned memory behind the x and y arrays of SOAPoints. The arrays are padded with
+// notOnHull up to a multiple of the alignment. Memory is kept when the buffer is reused for
+// fewer points.
+template <typename T>
+struct SOABuffer {
+	char* memory = nullptr;
+	size_t capacityBytes = 0;
+	size_t alignment = 0;
+	size_t numPoints = 0;
+	T* x = nullptr;
+	T* y = nullptr;
+	
+	SOABuffer() = default;
+	SOABuffer(const SOABuffer&) = delete;
+	SOABuffer& operator=(const SOABuffer&) = delete;
+	~SOABuffer() { std::free(memory); }
+	
+	void resize(size_t newNumPoints, size_t soaAlignment);
+	
+	// Alignment in bytes and padded array length used for a given implementation soaAlignment
+	static size_t alignmentFor(size_t soaAlignment);
+	static size_t paddedSize(size_t numPoints, size_t soaAlignment);
+	
+	SOAPoints<T> points() const {
+		return { .x = { x, numPoints }, .y = { y, numPoints } };
+	}
+};
@@ -0,0 +1,176 @@
+#include "streaming.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+
+template <typename T>
+void solveStreaming(PointInput& input, const HullSolveFunction<T>& solve, size_t chunkSize,
+                    std::vector<point<T>>& hull, StreamingStats& stats) {
+	std::vector<point<T>> chunk;
+	chunk.reserve(chunkSize);
+	hull.clear();
+	
+	for (uint64_t remaining = input.numPoints; remaining > 0;) {
+		size_t numRead = std::min<uint64_t>(chunkSize, remaining);
+		remaining -= numRead;
+		
+		auto beforeReadTime = std::chrono::high_resolution_clock::now();
+		chunk.assign(hull.begin(), hull.end());
+		chunk.resize(hull.size() + numRead);
+		if (!input.readPoints<T>(std::span<point<T>>(chunk).subspan(hull.size())))
+			break;
+		input.releaseConsumed();
+		
+		auto beforeSolveTime = std::chrono::high_resolution_clock::now();
+		// Only an input of one or two points gives a smaller first chunk
+		if (chunk.size() >= MIN_HULL_POINTS)
+			solve(chunk);
+		hull.swap(chunk);
+		auto afterSolveTime = std::chrono::high_resolution_clock::now();
+		
+		stats.numChunks++;
+		stats.readTimeMs += std::chrono::duration<double, std::milli>(beforeSolveTime - beforeReadTime).count();
+		stats.computeTimeMs += std::chrono::duration<double, std::milli>(afterSolveTime - beforeSolveTime).count();
+	}
+}
+
+template <typename T>
+void solvePipelined(PointInput& input, const HullSolveFunction<T>& solve, size_t chunkSize, size_t numWorkers,
+                    std::vector<point<T>>& hull, PipelineStats& stats) {
+	using clock = std::chrono::high_resolution_clock;
+	auto msSince = [] (clock::time_point t) { return std::chrono::duration<double, std::milli>(clock::now() - t).count(); };
+	
+	numWorkers = std::max<size_t>(numWorkers, 1);
+	
+	std::mutex mutex;
+	std::condition_variable freeCondition;
+	std::condition_variable readyCondition;
+	std::deque<std::vector<point<T>>> freeChunks(numWorkers + 1);
+	std::deque<std::vector<point<T>>> readyChunks;
+	bool readerDone = false;
+	
+	std::thread readerThread([&] {
+		for (uint64_t remaining = input.numPoints; remaining > 0;) {
+			auto beforeWaitTime = clock::now();
+			std::unique_lock<std::mutex> lock(mutex);
+			freeCondition.wait(lock, [&] { return !freeChunks.empty(); });
+			std::vector<point<T>> chunk = std::move(freeChunks.front());
+			freeChunks.pop_front();
+			lock.unlock();
+			stats.readStallTimeMs += msSince(beforeWaitTime);
+			
+			auto beforeReadTime = clock::now();
+			size_t numRead = std::min<uint64_t>(chunkSize, remaining);
+			remaining -= numRead;
+			chunk.resize(numRead);
+			if (!input.readPoints<T>(chunk))
+				break;
+			input.releaseConsumed();
+			stats.readTimeMs += msSince(beforeReadTime);
+			
+			lock.lock();
+			readyChunks.push_back(std::move(chunk));
+			stats.numChunks++;
+			lock.unlock();
+			readyCondition.notify_one();
+		}
+		
+		std::lock_guard<std::mutex> lock(mutex);
+		readerDone = true;
+		readyCondition.notify_all();
+	});
+	
+	std::vector<std::vector<point<T>>> workerHulls(numWorkers);
+	std::vector<double> workerComputeTimeMs(numWorkers);
+	std::vector<double> workerStallTimeMs(numWorkers);
+	
+	HullContext& context = currentHullContext();
+	auto workerTarget = [&] (size_t workerIndex) {
+		HullContextScope contextScope(context);
+		std::vector<point<T>>& workerHull = workerHulls[workerIndex];
+		while (true) {
+			auto beforeWaitTime = clock::now();
+			std::unique_lock<std::mutex> lock(mutex);
+			readyCondition.wait(lock, [&] { return !readyChunks.empty() || readerDone; });
+			if (readyChunks.empty())
+				break;
+			std::vector<point<T>> chunk = std::move(readyChunks.front());
+			readyChunks.pop_front();
+			lock.unlock();
+			workerStallTimeMs[workerIndex] += msSince(beforeWaitTime);
+			
+			auto beforeSolveTime = clock::now();
+			chunk.insert(chunk.end(), workerHull.begin(), workerHull.end());
+			// A trailing chunk of one or two points, on a worker without a hull yet, is carried as it is
+			if (chunk.size() >= MIN_HULL_POINTS)
+				solve(chunk);
+			workerHull.assign(chunk.begin(), chunk.end());
+			workerComputeTimeMs[workerIndex] += msSince(beforeSolveTime);
+			
+			lock.lock();
+			freeChunks.push_back(std::move(chunk));
+			lock.unlock();
+			freeCondition.notify_one();
+		}
+	};
+	
+	std::list<std::thread> workerThreads;
+	for (size_t i = 1; i < numWorkers; i++) {
+		workerThreads.emplace_back(workerTarget, i);
+	}
+	workerTarget(0);
+	for (std::thread& thread : workerThreads) {
+		thread.join();
+	}
+	readerThread.join();
+	
+	for (size_t i = 0; i < numWorkers; i++) {
+		stats.computeTimeMs += workerComputeTimeMs[i];
+		stats.computeStallTimeMs += workerStallTimeMs[i];
+	}
+	
+	auto beforeMergeTime = clock::now();
+	hull.clear();
+	for (const auto& workerHull : workerHulls) {
+		hull.insert(hull.end(), workerHull.begin(), workerHull.end());
+	}
+	if (numWorkers > 1 && hull.size() >= MIN_HULL_POINTS)
+		solve(hull);
+	stats.mergeTimeMs = msSince(beforeMergeTime);
+}
+
+template <typename T>
+HullSolveFunction<T> soaSolveAsAos(HullSolveFunctionSOA<T> solve, size_t soaAlignment) {
+	return [solve, soaAlignment] (std::vector<point<T>>& points) {
+		SOABuffer<T> buffer;
+		buffer.resize(points.size(), soaAlignment);
+		for (size_t i = 0; i < points.size(); i++) {
+			buffer.x[i] = points[i].x;
+			buffer.y[i] = points[i].y;
+		}
+		
+		size_t numHullPoints = solve(buffer.points());
+		
+		points.resize(numHullPoints);
+		for (size_t i = 0; i < numHullPoints; i++) {
+			points[i] = point<T>(buffer.x[i], buffer.y[i]);
+		}
+	};
+}
+
+template void solveStreaming<int64_t>(PointInput& input, const HullSolveFunction<int64_t>& solve, size_t chunkSize,
+                                      std::vector<point<int64_t>>& hull, StreamingStats& stats);
+template void solveStreaming<double>(PointInput& input, const HullSolveFunction<double>& solve, size_t chunkSize,
+                                     std::vector<point<double>>& hull, StreamingStats& stats);
+
+template void solvePipelined<int64_t>(PointInput& input, const HullSolveFunction<int64_t>& solve, size_t chunkSize, size_t numWorkers,
+                                      std::vector<point<int64_t>>& hull, PipelineStats& stats);
+template void solvePipelined<double>(PointInput& input, const HullSolveFunction<double>& solve, size_t chunkSize, size_t numWorkers,
+                                     std::vector<point<double>>& hull, PipelineStats& stats);
+
+template HullSolveFunction<int64_t> soaSolveAsAos<int64_t>(HullSolveFunctionSOA<int64_t> solve, size_t soaAlignment);
+template HullSolveFunction<double> soaSolveAsAos<double>(HullSolveFunctionSOA<double> solve, size_t soaAlignment);
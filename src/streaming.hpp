@@ -0,0 +1,39 @@
+#pragma once
+
+#include "hull_impl.hpp"
+#include "point_input.hpp"
+
+#include <vector>
+
+struct StreamingStats {
+	size_t numChunks = 0;
+	double readTimeMs = 0;
+	double computeTimeMs = 0;
+};
+
+// Computes the hull of the input chunkSize points at a time. Only the hull of the points seen so
+// far is kept between chunks, it is prepended to each new chunk before that is solved. Memory use
+// is therefore O(chunkSize + h) regardless of the number of input points.
+template <typename T>
+void solveStreaming(PointInput& input, const HullSolveFunction<T>& solve, size_t chunkSize,
+                    std::vector<point<T>>& hull, StreamingStats& stats);
+
+struct PipelineStats {
+	size_t numChunks = 0;
+	double readTimeMs = 0;        // time the reader thread spent reading
+	double readStallTimeMs = 0;   // time the reader thread waited for a free chunk buffer
+	double computeTimeMs = 0;     // summed over all workers
+	double computeStallTimeMs = 0;// summed over all workers, time spent waiting for a chunk to be read
+	double mergeTimeMs = 0;       // final pass over the partial hulls
+};
+
+// Like solveStreaming, but a reader thread fills the next chunk while numWorkers worker threads
+// reduce earlier chunks. Every worker keeps its own running hull, the partial hulls are combined
+// in a final pass. At most numWorkers + 1 chunks are in memory at once.
+template <typename T>
+void solvePipelined(PointInput& input, const HullSolveFunction<T>& solve, size_t chunkSize, size_t numWorkers,
+                    std::vector<point<T>>& hull, PipelineStats& stats);
+
+// Wraps an SOA implementation so it can be used where an AOS one is expected
+template <typename T>
+HullSolveFunction<T> soaSolveAsAos(HullSolveFunctionSOA<T> solve, size_t soaAlignment);
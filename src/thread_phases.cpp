@@ -0,0 +1,163 @@
+#include "thread_phases.hpp"
+#include "hull_context.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static std::atomic<uint64_t> nextGeneration { 1 };
+
+// Reference points of the phase clock and the steady clock, taken when the library is loaded
+static const uint64_t clockStartTicks = readPhaseClock();
+static const std::chrono::steady_clock::time_point clockStartTime = std::chrono::steady_clock::now();
+
+double phaseTicksToMs(uint64_t ticks) {
+#if defined(__x86_64__) || defined(__i386__)
+	// The ratio of the two clocks since the start, measured over at least 10 ms to be accurate
+	static const double msPerTick = [] {
+		auto minEndTime = clockStartTime + std::chrono::milliseconds(10);
+		while (std::chrono::steady_clock::now() < minEndTime) { }
+		uint64_t endTicks = readPhaseClock();
+		auto endTime = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(endTime - clockStartTime).count() / static_cast<double>(endTicks - clockStartTicks);
+	}();
+	return static_cast<double>(ticks) * msPerTick;
+#else
+	return static_cast<double>(ticks) / 1e6;
+#endif
+}
+
+// Record of the calling thread in the ThreadPhases it last used, so that finding it takes no lock
+struct CachedRecord {
+	const ThreadPhases* owner = nullptr;
+	uint64_t generation = 0;
+	ThreadPhaseRecord* record = nullptr;
+};
+
+static thread_local CachedRecord cachedRecord;
+
+static int openThreadCounter(uint32_t type, uint64_t config, int groupFd) {
+	perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP;
+	return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+ThreadPhaseRecord::~ThreadPhaseRecord() {
+	if (missesFd >= 0)
+		close(missesFd);
+	if (counterFd >= 0)
+		close(counterFd);
+}
+
+void ThreadPhaseRecord::openCounters() {
+	counterFd = openThreadCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, -1);
+	if (counterFd < 0)
+		return;
+	missesFd = openThreadCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, counterFd);
+	if (missesFd < 0) {
+		close(counterFd);
+		counterFd = -1;
+	}
+}
+
+bool ThreadPhaseRecord::readCounters(uint64_t (&values)[2]) const {
+	if (counterFd < 0)
+		return false;
+	uint64_t group[3];
+	if (read(counterFd, group, sizeof(group)) != static_cast<ssize_t>(sizeof(group)) || group[0] != 2)
+		return false;
+	values[0] = group[1];
+	values[1] = group[2];
+	return true;
+}
+
+PhaseTotals& ThreadPhaseRecord::phase(std::string_view name) {
+	for (PhaseTotals& totals : phases) {
+		if (totals.name == name)
+			return totals;
+	}
+	phases.push_back(PhaseTotals { .name = name });
+	return phases.back();
+}
+
+ThreadPhases::ThreadPhases() : startTicks(readPhaseClock()), generation(nextGeneration++) { }
+
+void ThreadPhases::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	records.clear();
+	generation = nextGeneration++;
+	startTicks = readPhaseClock();
+}
+
+std::vector<const ThreadPhaseRecord*> ThreadPhases::getRecords() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<const ThreadPhaseRecord*> result;
+	for (const ThreadPhaseRecord& record : records) {
+		result.push_back(&record);
+	}
+	return result;
+}
+
+ThreadPhaseRecord& ThreadPhases::recordOfThisThread() {
+	if (cachedRecord.owner == this && cachedRecord.generation == generation)
+		return *cachedRecord.record;
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	ThreadPhaseRecord& record = records.emplace_back(records.size());
+	record.recordSpans = recordSpans;
+	if (useCounters)
+		record.openCounters();
+	cachedRecord = { .owner = this, .generation = generation.load(), .record = &record };
+	return record;
+}
+
+#ifndef NO_PHASE_TIMERS
+void PhaseScope::start() {
+	running = true;
+	childTicks = 0;
+	childCounters[0] = childCounters[1] = 0;
+	parent = record->innermost;
+	record->innermost = this;
+	hasCounters = record->readCounters(startCounters);
+	startTicks = readPhaseClock();
+}
+
+void PhaseScope::end() {
+	uint64_t ticks = readPhaseClock() - startTicks;
+	uint64_t endCounters[2];
+	bool hasEndCounters = hasCounters && record->readCounters(endCounters);
+	
+	PhaseTotals& totals = record->phase(name);
+	totals.count++;
+	totals.inclusiveTicks += ticks;
+	totals.exclusiveTicks += ticks - std::min(childTicks, ticks);
+	if (hasEndCounters) {
+		uint64_t instructions = endCounters[0] - startCounters[0];
+		uint64_t llcMisses = endCounters[1] - startCounters[1];
+		totals.instructions = totals.instructions.value_or(0) + (instructions - std::min(childCounters[0], instructions));
+		totals.llcMisses = totals.llcMisses.value_or(0) + (llcMisses - std::min(childCounters[1], llcMisses));
+		if (parent != nullptr) {
+			parent->childCounters[0] += instructions;
+			parent->childCounters[1] += llcMisses;
+		}
+	}
+	
+	if (record->recordSpans)
+		record->spans.push_back(PhaseSpan { .name = name, .startTicks = startTicks, .endTicks = startTicks + ticks });
+	if (parent != nullptr)
+		parent->childTicks += ticks;
+	record->innermost = parent;
+	running = false;
+}
+#endif
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Clock of the phase timers: the time stamp counter where there is one, nanoseconds otherwise.
+// Ticks are converted to time when reporting, see phaseTicksToMs.
+inline uint64_t readPhaseClock() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+double phaseTicksToMs(uint64_t ticks);
+
+// Totals of one thread in one named phase. Inclusive time covers the whole scope, exclusive time
+// leaves out the phases nested in it. Counters are exclusive too, so that they add up per thread.
+struct PhaseTotals {
+	std::string_view name;
+	uint64_t count = 0;
+	uint64_t inclusiveTicks = 0;
+	uint64_t exclusiveTicks = 0;
+	std::optional<uint64_t> instructions;
+	std::optional<uint64_t> llcMisses;
+};
+
+// One run of a phase on one thread, kept for the trace when ThreadPhases::recordSpans is set
+struct PhaseSpan {
+	std::string_view name;
+	uint64_t startTicks;
+	uint64_t endTicks;
+};
+
+struct PhaseScope;
+
+// What one thread working on a solve spent in each phase. Only the thread itself adds to it.
+struct ThreadPhaseRecord {
+	size_t threadIndex;
+	std::vector<PhaseTotals> phases;
+	PhaseScope* innermost = nullptr;
+	bool recordSpans = false;
+	std::vector<PhaseSpan> spans;
+	
+	// perf_event_open counters of this thread alone: instructions as group leader, LLC misses as member.
+	// -1 when counters are disabled or not available.
+	int counterFd = -1;
+	int missesFd = -1;
+	
+	explicit ThreadPhaseRecord(size_t _threadIndex) : threadIndex(_threadIndex) { }
+	ThreadPhaseRecord(const ThreadPhaseRecord&) = delete;
+	ThreadPhaseRecord& operator=(const ThreadPhaseRecord&) = delete;
+	~ThreadPhaseRecord();
+	
+	void openCounters();
+	bool readCounters(uint64_t (&values)[2]) const;
+	PhaseTotals& phase(std::string_view name);
+};
+
+// Per thread and per phase attribution of the work of a solve, so that load imbalance between the
+// threads of a parallel implementation shows up. Off unless enabled, then every thread that enters
+// a PhaseScope under the context gets a record, numbered in the order the threads first show up.
+struct ThreadPhases {
+	bool enabled = false;
+	bool useCounters = false;
+	// Also keeps every span of every phase, in the order they end, for a timeline of the solve
+	bool recordSpans = false;
+	// Phase clock when the records were last cleared, where the timeline starts
+	uint64_t startTicks;
+	
+	ThreadPhases();
+	
+	void clear();
+	
+	// Snapshot of the records, to be taken once the threads of the solve are done
+	std::vector<const ThreadPhaseRecord*> getRecords() const;
+	
+	ThreadPhaseRecord& recordOfThisThread();
+	
+	mutable std::mutex mutex;
+	std::list<ThreadPhaseRecord> records;
+	std::atomic<uint64_t> generation;
+};
+
+// Attributes the time, and with ThreadPhases::useCounters the instructions and LLC misses, between
+// construction and destruction to phase name of the calling thread in the current HullContext.
+// switchTo moves on to the next phase of a sequence without opening a new block.
+// Scopes nest: a scope opened while another one is running on the same thread is charged to the
+// outer scope's inclusive time only. Costs a check of the context when phases are not collected,
+// and nothing when built with NO_PHASE_TIMERS. The constructor is defined in hull_context.hpp.
+#ifndef NO_PHASE_TIMERS
+struct PhaseScope {
+	ThreadPhaseRecord* record = nullptr;
+	PhaseScope* parent = nullptr;
+	std::string_view name;
+	bool running = false;
+	uint64_t startTicks = 0;
+	uint64_t childTicks = 0;
+	uint64_t startCounters[2] = { 0, 0 };
+	uint64_t childCounters[2] = { 0, 0 };
+	bool hasCounters = false;
+	
+	explicit PhaseScope(std::string_view _name);
+	~PhaseScope() {
+		if (running)
+			end();
+	}
+	PhaseScope(const PhaseScope&) = delete;
+	PhaseScope& operator=(const PhaseScope&) = delete;
+	
+	// Ends the phase, if it is running, and starts phase newName in its place
+	void switchTo(std::string_view newName) {
+		if (record == nullptr)
+			return;
+		if (running)
+			end();
+		name = newName;
+		start();
+	}
+	
+	// Ends the phase early, switchTo starts another one
+	void stop() {
+		if (running)
+			end();
+	}
+	
+	void start();
+	void end();
+};
+#else
+struct PhaseScope {
+	explicit PhaseScope(std::string_view) { }
+	PhaseScope(const PhaseScope&) = delete;
+	PhaseScope& operator=(const PhaseScope&) = delete;
+	
+	void switchTo(std::string_view) { }
+	void stop() { }
+};
+#endif
@@ -0,0 +1,64 @@
+#Usage: python3 test_input.py [-i=mc]
+#Checks that ch.bin reads text input the same with one and with several read threads. The inputs are built so that
+#the parse window, which PointInput::readInto estimates from the length of the first 256 lines, ends in the middle
+#of the last point of a record: the first lines are short and later ones slightly longer. Also checks that text
+#piped to ch.bin with fewer points than its header announces is rejected, as it is when read from a file.
+
+import testlib
+import os
+import subprocess
+import sys
+import tempfile
+
+NUM_SAMPLED_LINES = 256 # lines estimateLinesEnd averages over
+LAST_LINE = "7 123456789\n"
+
+def windowCrossingRecord(numPoints, cutAt):
+	#Text lines of numPoints points in which the byte estimated as the end of the points falls cutAt bytes
+	#into the last line
+	estimate = 5 * numPoints + 4096 # 4 bytes per sampled line, times 1.25, plus the slack
+	lines = ["0 0\n"] * NUM_SAMPLED_LINES
+	size = 4 * NUM_SAMPLED_LINES
+	numLonger = estimate - cutAt - size - 5 * (numPoints - NUM_SAMPLED_LINES - 1)
+	for i in range(numPoints - NUM_SAMPLED_LINES - 1):
+		lines.append("1 111\n" if i < numLonger else "1 11\n")
+	lines.append(LAST_LINE)
+	return f"2\n{numPoints}\n" + "".join(lines)
+
+def runCh(path, implName, args):
+	proc = subprocess.run(["./ch.bin", implName, f"-in={path}"] + args, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+	return proc.returncode, proc.stdout.decode()
+
+implName = testlib.getcmdarg("i", "mc")
+numPoints = 600000
+cases = {
+	# Trailing text after the record, so that the window does not reach the end of the input
+	"cut in last line": (windowCrossingRecord(numPoints, 5) + "0 0\n", []),
+	"cut after last digit": (windowCrossingRecord(numPoints, len(LAST_LINE) - 1) + "0 0\n", []),
+	"batch": (windowCrossingRecord(numPoints, 5) + windowCrossingRecord(numPoints, 7), ["-batch"]),
+}
+
+failed = 0
+with tempfile.TemporaryDirectory() as tmp:
+	for name, (text, args) in cases.items():
+		path = os.path.join(tmp, "input.txt")
+		with open(path, "w") as f:
+			f.write(text)
+		expected = runCh(path, implName, args + ["-rt1"])
+		for numThreads in [2, 4]:
+			if runCh(path, implName, args + [f"-rt{numThreads}"]) != expected:
+				print(f"{name}: output with -rt{numThreads} differs from -rt1")
+				failed += 1
+		if expected[0] != 0 or "123456789" not in expected[1]:
+			print(f"{name}: -rt1 did not read the last point")
+			failed += 1
+
+#Piped, not given with -in, so that it is read from a stream instead of being mapped
+truncatedText = b"2\n10\n1000.5 2000.5\n1.5 2.5\n3.5 0.5\n"
+proc = subprocess.run(["./ch.bin", implName], input=truncatedText, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+if proc.returncode == 0 or b"truncated" not in proc.stderr:
+	print("piped truncated text: not rejected")
+	failed += 1
+
+print(f"{len(cases) + 1} cases, {failed} failures")
+sys.exit(1 if failed else 0)
@@ -0,0 +1,79 @@
+#Usage: python3 test_server.py [-i=mc]
+#Sends malformed and degenerate requests to "./ch.bin -server=socket_path" and checks that each one gets an error
+#reply and that the server goes on answering, on the same connection when the request was framed and on a new
+#one when it was not.
+
+import testlib
+import os
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+implName = testlib.getcmdarg("i", "mc")
+VALID_PAYLOAD = b"2\n4\n0 0\n2 0\n1 1\n1 3\n"
+
+class Connection:
+	def __init__(self, socketPath):
+		self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+		self.sock.connect(socketPath)
+		self.file = self.sock.makefile("rb")
+	def request(self, header, payload=b""):
+		#Returns the status of the reply, None if the server closed the connection
+		try:
+			self.sock.sendall(header + payload)
+			line = self.file.readline().decode().split()
+		except OSError:
+			return None
+		if not line:
+			return None
+		self.file.read(int(line[1]))
+		return line[0]
+	def close(self):
+		self.file.close()
+		self.sock.close()
+
+def validRequest(conn):
+	return conn.request(f"{implName} {len(VALID_PAYLOAD)}\n".encode(), VALID_PAYLOAD)
+
+#Name, request header, payload, whether the server keeps the connection open
+cases = [
+	("0 points", f"{implName} 4\n".encode(), b"2\n0\n", True),
+	("1 point", f"{implName} 8\n".encode(), b"2\n1\n1 1\n", True),
+	("2 points", f"{implName} 12\n".encode(), b"2\n2\n1 1\n2 2\n", True),
+	("count larger than payload", f"{implName} 12\n".encode(), b"2\n99999\n1 1\n", True),
+	("oversized payload", f"{implName} 999999999999999\n".encode(), b"", False),
+]
+
+failed = 0
+with tempfile.TemporaryDirectory() as tmp:
+	socketPath = os.path.join(tmp, "server.sock")
+	server = subprocess.Popen(["./ch.bin", f"-server={socketPath}"], stderr=subprocess.DEVNULL)
+	while not os.path.exists(socketPath):
+		time.sleep(0.01)
+	try:
+		for name, header, payload, keepsConnection in cases:
+			conn = Connection(socketPath)
+			if conn.request(header, payload) != "error":
+				print(f"{name}: no error reply")
+				failed += 1
+			if keepsConnection and validRequest(conn) != "ok":
+				print(f"{name}: the next request on the connection failed")
+				failed += 1
+			conn.close()
+			if server.poll() is not None:
+				print(f"{name}: the server exited with {server.returncode}")
+				failed += 1
+				break
+			conn = Connection(socketPath)
+			if validRequest(conn) != "ok":
+				print(f"{name}: a request on a new connection failed")
+				failed += 1
+			conn.close()
+	finally:
+		server.kill()
+		server.wait()
+
+print(f"{len(cases)} cases, {failed} failures")
+sys.exit(1 if failed else 0)
@@ -1,5 +1,6 @@
 import subprocess
 import os, sys
+import json, tempfile
 
 def getcmdarg(name, default=None):
 	for i in range(1, len(sys.argv)):
@@ -28,32 +29,83 @@ def findResult(output: str, label: str):
 		value = value[:-1]
 	return float(value.replace(",", ""))
 
-def run(inputFile, implementation, extraArgs=[], timeout = 10, maxThreads=None, metric="time"):
+_loadedPoints = {}
+
+def loadPoints(inputFile, dtype):
+	#Reads a text or binary (B/I) input file into an (n, 2) array, caching the result
+	import numpy as np
+	key = (inputFile, np.dtype(dtype))
+	if key not in _loadedPoints:
+		with open(inputFile, "rb") as f:
+			data = f.read()
+		if data[:1] in [b"B", b"I"]:
+			n = int.from_bytes(data[1:9], "little")
+			points = np.frombuffer(data, dtype=np.float64 if data[:1] == b"B" else np.int64, count=2*n, offset=9).reshape(n, 2)
+		else:
+			points = np.loadtxt(data.decode().splitlines()[2:], dtype=np.float64, ndmin=2)
+		_loadedPoints[key] = np.round(points).astype(dtype) if np.dtype(dtype) == np.int64 else points.astype(dtype)
+	return _loadedPoints[key]
+
+def runInProcess(inputFile, implementation, extraArgs=[]):
+	#Calls the implementation through libconvexhull instead of starting ch.bin, returns the compute time
+	import convexhull
+	import numpy as np
+	dtype = np.int64 if "-i" in extraArgs else np.float64
+	_, timings = convexhull.solve(implementation, loadPoints(inputFile, dtype).copy())
+	return timings.computeMs
+
+def run(inputFile, implementation, extraArgs=[], timeout = 10, maxThreads=None, metric="time", inProcess=False):
 	if implementation == "qhull":
 		return runQhull(inputFile, timeout)
+	if inProcess and metric == "time" and maxThreads is None and all(a == "-i" for a in extraArgs):
+		return runInProcess(inputFile, implementation, extraArgs)
 	command = ['./ch.bin', '-q', implementation] + extraArgs
 	if metric in ["cacheMisses", "cacheMissRate"]:
 		command = ["valgrind", "--tool=cachegrind", "--cachegrind-out-file=/dev/null"] + command
 	if maxThreads is not None:
 		command = ["taskset", "--cpu-list", "0-" + str(maxThreads - 1)] + command
+	if metric == "time":
+		with tempfile.NamedTemporaryFile(suffix=".json") as report:
+			with open(inputFile, "r") as f:
+				subprocess.run(command + [f"-json={report.name}"], stdin=f, stderr=subprocess.PIPE, stdout=subprocess.PIPE, timeout = timeout)
+			return json.load(report)["compute_time_ms"]
 	with open(inputFile, "r") as f:
 		proc = subprocess.run(command, stdin=f, stderr=subprocess.PIPE, stdout=subprocess.PIPE, timeout = timeout)
 		output = proc.stderr.decode("utf-8")
 	return findResult(output, {
 		"cacheMisses": "LL misses:",
-		"cacheMissRate": "LL miss rate:",
-		"time": "compute time:"
+		"cacheMissRate": "LL miss rate:"
 	}[metric])
 
-def runOnAllFiles(datasets, implementation, runs=1, datasetSize="large", extraArgs=[], maxThreads=None, metric="time"):
+def runRepeated(inputFile, implementation, runs, warmups=0, extraArgs=[], timeout = 10, maxThreads=None):
+	#Solves the input runs times in one ch.bin process (-r, -w), returns the compute time of every measured run
+	command = ['./ch.bin', '-q', implementation, f"-r={runs}", f"-w={warmups}"] + extraArgs
+	if maxThreads is not None:
+		command = ["taskset", "--cpu-list", "0-" + str(maxThreads - 1)] + command
+	with tempfile.NamedTemporaryFile(suffix=".json") as report:
+		with open(inputFile, "r") as f:
+			proc = subprocess.run(command + [f"-json={report.name}"], stdin=f, stderr=subprocess.PIPE, stdout=subprocess.PIPE, timeout = timeout * (runs + warmups))
+		if proc.returncode != 0:
+			message = (proc.stderr + proc.stdout).decode("utf-8").strip()
+			raise RuntimeError(f"{' '.join(command)} < {inputFile} failed with exit code {proc.returncode}: {message}")
+		return json.load(report)["run_times_ms"]
+
+def runOnAllFiles(datasets, implementation, runs=1, datasetSize="large", extraArgs=[], maxThreads=None, metric="time", inProcess=False, repeatInOneProcess=False):
+	#repeatInOneProcess times every file runs times in one ch.bin process with runRepeated instead of starting
+	#ch.bin once per run and file, so the runs after the first find the input and the code in cache
 	if type(datasets) != type([]):
 		datasets = [datasets]
 	times = []
 	for dataset in datasets:
 		dirpath = f".testcases/{dataset}/{datasetSize}"
 		files = list(filter(lambda f: f.endswith(".in"), os.listdir(dirpath)))
+		if repeatInOneProcess and metric == "time" and not inProcess and implementation != "qhull":
+			#The input is read once per file and solved runs times in the same process
+			for file in files:
+				times.extend(runRepeated(dirpath + "/" + file, implementation, runs, extraArgs=extraArgs, maxThreads=maxThreads))
+			continue
 		for r in range(runs):
 			for file in files:
-				time = run(dirpath + "/" + file, implementation, extraArgs, maxThreads=maxThreads, metric=metric)
+				time = run(dirpath + "/" + file, implementation, extraArgs, maxThreads=maxThreads, metric=metric, inProcess=inProcess)
 				times.append(time)
 	return sum(times) / len(times)
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+
+// The distributions of the gen*.bin generators, also used by the tools that generate their input in process
+// (bench/suite.cpp, bench/microbench.cpp and fuzz/fuzz.cpp) through namedDistributions.
+// Point is any type with double x and y members, Rng a standard random number engine.
+
+template <typename Point, typename Rng>
+void generateCircle(std::span<Point> points, Rng& rng, double radius) {
+	std::uniform_real_distribution<double> angleDistribution(0, std::numbers::pi_v<double> * 2);
+	for (Point& p : points) {
+		double angle = angleDistribution(rng);
+		p.x = std::cos(angle) * radius;
+		p.y = std::sin(angle) * radius;
+	}
+}
+
+template <typename Point, typename Rng>
+void generateSquare(std::span<Point> points, Rng& rng, double min, double max) {
+	std::uniform_real_distribution<double> distribution(min, max);
+	
+	double rotation = std::uniform_real_distribution<double>(0, M_PI * 2)(rng);
+	double cosR = std::cos(rotation);
+	double sinR = std::sin(rotation);
+	
+	for (Point& p : points) {
+		double x = distribution(rng);
+		double y = distribution(rng);
+		p.x = cosR * x - sinR * y;
+		p.y = sinR * x + cosR * y;
+	}
+}
+
+template <typename Point, typename Rng>
+void generateDisk(std::span<Point> points, Rng& rng, double radius) {
+	std::uniform_real_distribution<double> distribution(-radius, radius);
+	
+	for (Point& p : points) {
+		double x,y;
+		do { // Loop until generating a point in the disk
+			x = distribution(rng);
+			y = distribution(rng);
+		} while (x*x + y*y > radius*radius);
+		p.x = x;
+		p.y = y;
+	}
+}
+
+// Points on a circle inside a triangle of three extra points, so that merging hulls finds almost nothing to drop
+template <typename Point, typename Rng>
+void generateMergeKiller(std::span<Point> points, Rng& rng, double radius) {
+	generateCircle(points, rng, radius);
+	points[0].x = -2*radius, points[0].y = -radius; // (-2r,-r)
+	points[1].x = 2*radius, points[1].y = -radius; //(2r,-r)
+	points[2].x = 0, points[2].y = 2*radius; //(0,2r)
+}
+
+// The distributions by name, with the default parameters of the gen*.bin tools. scale is the radius or half
+// the side length, the magnitude of the coordinates.
+template <typename Point>
+struct NamedDistribution {
+	std::string_view name;
+	double scale;
+	void (*generate)(std::span<Point> points, std::mt19937& rng);
+};
+
+template <typename Point>
+inline constexpr NamedDistribution<Point> namedDistributions[] = {
+	{ "circle", 1000, [] (std::span<Point> points, std::mt19937& rng) { generateCircle<Point>(points, rng, 1000); } },
+	{ "square", 100, [] (std::span<Point> points, std::mt19937& rng) { generateSquare<Point>(points, rng, -100, 100); } },
+	{ "disk", 100, [] (std::span<Point> points, std::mt19937& rng) { generateDisk<Point>(points, rng, 100); } },
+	{ "mergekiller", 1000, [] (std::span<Point> points, std::mt19937& rng) { generateMergeKiller<Point>(points, rng, 1000); } },
+};
+
+// nullptr if there is no distribution of that name
+template <typename Point>
+const NamedDistribution<Point>* findNamedDistribution(std::string_view name) {
+	for (const NamedDistribution<Point>& distribution : namedDistributions<Point>) {
+		if (distribution.name == name)
+			return &distribution;
+	}
+	return nullptr;
+}
+
+// The names, comma separated, for error messages
+template <typename Point>
+std::string namedDistributionList() {
+	std::string list;
+	for (const NamedDistribution<Point>& distribution : namedDistributions<Point>) {
+		list += (list.empty() ? "" : ", ") + std::string(distribution.name);
+	}
+	return list;
+}
@@ -9,6 +9,8 @@
 #include <iostream>
 #include <iomanip>
 #include <string_view>
+#include <cmath>
+#include <cstdint>
 
 using rand_generator = std::mt19937;
 
@@ -27,8 +29,29 @@ int getArgOrDefault(std::string_view name, int def = 0) {
 
 void generatePoints(std::vector<point>& points, rand_generator& rng);
 
-void writeOutput(std::ostream& stream, const std::vector<point>& points) {
+void writeIntOutput(std::ostream& stream, const std::vector<point>& points) {
+	std::vector<std::pair<int64_t, int64_t>> pointsi(points.size());
+	for (size_t i = 0; i < points.size(); i++) {
+		pointsi[i] = { std::llround(points[i].x), std::llround(points[i].y) };
+	}
+	
 	if (getArgOrDefault("bin")) {
+		stream.put('I');
+		uint64_t numPoints = points.size();
+		stream.write(reinterpret_cast<const char*>(&numPoints), sizeof(numPoints));
+		stream.write(reinterpret_cast<const char*>(pointsi.data()), pointsi.size() * sizeof(pointsi[0]));
+	} else {
+		stream << "2\n" << points.size() << "\n";
+		for (const auto& [x, y] : pointsi) {
+			stream << x << " " << y << "\n";
+		}
+	}
+}
+
+void writeOutput(std::ostream& stream, const std::vector<point>& points) {
+	if (getArgOrDefault("int")) {
+		writeIntOutput(stream, points);
+	} else if (getArgOrDefault("bin")) {
 		stream.put('B');
 		uint64_t numPoints = points.size();
 		stream.write(reinterpret_cast<const char*>(&numPoints), sizeof(numPoints));
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+// Splits a comma separated list argument of the tools (-n=, -gen=, -dist=), skipping empty items
+inline std::vector<std::string_view> splitList(std::string_view list) {
+	std::vector<std::string_view> items;
+	while (!list.empty()) {
+		size_t commaPos = std::min(list.find(','), list.size());
+		if (commaPos != 0)
+			items.push_back(list.substr(0, commaPos));
+		list.remove_prefix(std::min(commaPos + 1, list.size()));
+	}
+	return items;
+}